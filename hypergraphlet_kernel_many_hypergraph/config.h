@@ -29,19 +29,20 @@
 #define HYPEREDGES_SIMILARITY_THRESHOLD 1.0
 #define HYPERGRAPHLET_SIMILARITY_THRESHOLD 1.0
 
+// Defaults of the runtime configuration flags declared below (see run_hypergraphkernel -H, -X, -U and -o).
 // Flags for setting best hypergraphlets combination.
-#define HYPERGRAPHLETS_1 1  // If 1 count 1-hypergraphlets, otherwise ignore 1-hypergraphlets.
-#define HYPERGRAPHLETS_2 1  // If 1 count 2-hypergraphlets, otherwise ignore 2-hypergraphlets.
-#define HYPERGRAPHLETS_3 1  // If 1 count 3-hypergraphlets, otherwise ignore 3-hypergraphlets.
-#define HYPERGRAPHLETS_4 1  // If 1 count 4-hypergraphlets, otherwise ignore 4-hypergraphlets.
+#define DEFAULT_HYPERGRAPHLETS_1 1  // If 1 count 1-hypergraphlets, otherwise ignore 1-hypergraphlets.
+#define DEFAULT_HYPERGRAPHLETS_2 1  // If 1 count 2-hypergraphlets, otherwise ignore 2-hypergraphlets.
+#define DEFAULT_HYPERGRAPHLETS_3 1  // If 1 count 3-hypergraphlets, otherwise ignore 3-hypergraphlets.
+#define DEFAULT_HYPERGRAPHLETS_4 1  // If 1 count 4-hypergraphlets, otherwise ignore 4-hypergraphlets.
 
-#define ENABLE_INDUCED_HYPERGRAPHLETS 1     // If 1 enable counting of partial decompositions of large
+#define DEFAULT_ENABLE_INDUCED_HYPERGRAPHLETS 1     // If 1 enable counting of partial decompositions of large
                                             // hyperedges via induced subhypergraph definition (C. Berge, 1980),
                                             // otherwise ignore partial decomposition of hyperedges.
 
-#define DISABLE_MULTIPLICITY 0    // If 1 restrict induced hypergraphlets from having equivalent hyperedges with same label.
+#define DEFAULT_DISABLE_MULTIPLICITY 0    // If 1 restrict induced hypergraphlets from having equivalent hyperedges with same label.
 
-#define OUTPUT_FORMAT 2 // If 0 print triangular kernel matrix in binary format (for efficient SVM^light);
+#define DEFAULT_OUTPUT_FORMAT 2 // If 0 print triangular kernel matrix in binary format (for efficient SVM^light);
                         // If 1 print triangular kernel matrix to standard output;
                         // Otherwise print square kernel matrix to standard output.
 
@@ -54,6 +55,18 @@
 using namespace std;
 
 
+// Runtime configuration flags, initialized to the defaults above.
+extern bool HYPERGRAPHLETS_1, HYPERGRAPHLETS_2, HYPERGRAPHLETS_3, HYPERGRAPHLETS_4;
+extern bool ENABLE_INDUCED_HYPERGRAPHLETS;
+extern bool DISABLE_MULTIPLICITY;
+extern int OUTPUT_FORMAT;
+
+// Codes packed into keys for each vertex and edge label (0 for ZERO_CHAR and unknown labels), and their inverse.
+// Set by assign_label_codes() before any hypergraphlet is counted.
+extern unsigned char NODE_LABEL_CODE[256], EDGE_LABEL_CODE[256];
+extern char NODE_CODE_LABEL[NODES_ALPHABET_SIZE+1], EDGE_CODE_LABEL[HYPEREDGES_ALPHABET_SIZE+1];
+
+
 typedef uint64_t Element;
 typedef pair <Element, Element> Key;
 
@@ -67,4 +80,18 @@ struct MismatchInfo
                                             // substitutions algorithm and satisfying HYPERGRAPHLET_SIMILARITY_THRESHOLD (defined above).
 };
 
+
+// Edit operations explored by the generalized edit distance hypergraphlet kernel.
+#define VERTEX_LABEL_SUBSTITUTION 0
+#define HYPEREDGE_LABEL_SUBSTITUTION 1
+#define HYPEREDGE_INDEL 2
+
+// Labeled hypergraphlet reachable from another labeled hypergraphlet by exactly one edit operation.
+struct EditOperation
+{
+    unsigned char operation;    // One of VERTEX_LABEL_SUBSTITUTION, HYPEREDGE_LABEL_SUBSTITUTION or HYPEREDGE_INDEL.
+    unsigned long hg_type;      // Hypergraphlet type after the edit operation (only hyperedge indels change it).
+    Key key;                    // Vertex and hyperedge labels key after the edit operation.
+};
+
 #endif
@@ -0,0 +1,190 @@
+#include "hypergraphcontainer.h"
+#include <string.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <iostream>
+#include <fstream>
+#include <set>
+
+// File layout: a 24-byte header (magic, version, number of records, index offset), the records, each starting on
+// an 8-byte boundary, and the index with one (offset, size, name length, name) entry per record.
+// A record is (number of vertex labels, number of edge labels, number of pairs), the (edge, vertex) pairs and the labels.
+static const char CONTAINER_MAGIC[4] = {'H', 'G', 'C', 'T'};
+static const uint32_t CONTAINER_VERSION = 1;
+static const size_t HEADER_SIZE = 24;
+static const size_t RECORD_HEADER_SIZE = 16;
+
+
+void HypergraphContainer::open(const string &file)  {
+    close();
+    filename = file;
+
+    int fd = ::open(file.c_str(), O_RDONLY);
+    if (fd < 0)  {
+        cerr << "ERROR: Hypergraph container " << file << " could not be opened." << endl; exit(1);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0)  {
+        cerr << "ERROR: Hypergraph container " << file << " could not be read." << endl; exit(1);
+    }
+    size = st.st_size;
+    if (size < HEADER_SIZE)  {
+        cerr << "ERROR: File " << file << " is not a hypergraph container." << endl; exit(1);
+    }
+    data = (const char*) mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED)  {
+        data = NULL;
+        cerr << "ERROR: Hypergraph container " << file << " could not be mapped." << endl; exit(1);
+    }
+
+    uint32_t version;
+    uint64_t count, index_offset;
+    memcpy(&version, data + 4, sizeof(version));
+    memcpy(&count, data + 8, sizeof(count));
+    memcpy(&index_offset, data + 16, sizeof(index_offset));
+    if (memcmp(data, CONTAINER_MAGIC, sizeof(CONTAINER_MAGIC)) != 0 || version != CONTAINER_VERSION)  {
+        cerr << "ERROR: File " << file << " is not a hypergraph container." << endl; exit(1);
+    }
+    if (index_offset < HEADER_SIZE || index_offset > size)  {
+        cerr << "ERROR: Hypergraph container " << file << " is truncated." << endl; exit(1);
+    }
+
+    // Read the index of records by name.
+    const char *p = data + index_offset;
+    const char *end = data + size;
+    for (uint64_t i=0; i<count; i++)  {
+        uint64_t offset, record_size;
+        uint32_t name_size;
+        if ((size_t) (end - p) < 2 * sizeof(uint64_t) + sizeof(uint32_t))  {
+            cerr << "ERROR: Hypergraph container " << file << " is truncated." << endl; exit(1);
+        }
+        memcpy(&offset, p, sizeof(offset));
+        memcpy(&record_size, p + 8, sizeof(record_size));
+        memcpy(&name_size, p + 16, sizeof(name_size));
+        p += 2 * sizeof(uint64_t) + sizeof(uint32_t);
+        if ((size_t) (end - p) < name_size || offset % 8 != 0 || offset < HEADER_SIZE || record_size < RECORD_HEADER_SIZE || offset + record_size > index_offset)  {
+            cerr << "ERROR: Hypergraph container " << file << " is truncated." << endl; exit(1);
+        }
+        index[string(p, name_size)] = make_pair(offset, record_size);
+        p += name_size;
+    }
+}
+
+
+void HypergraphContainer::close()  {
+    if (data != NULL)
+        munmap((void*) data, size);
+    data = NULL;
+    size = 0;
+    index.clear();
+}
+
+
+const char* HypergraphContainer::find_record(const string &name, uint32_t &num_node_labels, uint32_t &num_edge_labels, uint64_t &num_pairs) const  {
+    map<string, pair<uint64_t, uint64_t> >::const_iterator it = index.find(name);
+    if (it == index.end())  {
+        cerr << "ERROR: Hypergraph " << name << " not found in hypergraph container " << filename << "." << endl; exit(1);
+    }
+    const char *record = data + it->second.first;
+    memcpy(&num_node_labels, record, sizeof(num_node_labels));
+    memcpy(&num_edge_labels, record + 4, sizeof(num_edge_labels));
+    memcpy(&num_pairs, record + 8, sizeof(num_pairs));
+    if (it->second.second < RECORD_HEADER_SIZE + num_pairs * 2 * sizeof(unsigned) + num_node_labels + num_edge_labels)  {
+        cerr << "ERROR: Record of hypergraph " << name << " is truncated in hypergraph container " << filename << "." << endl; exit(1);
+    }
+    return record;
+}
+
+SimpleHypergraph HypergraphContainer::read_hypergraph(const string &name, bool dual) const  {
+    uint32_t num_node_labels, num_edge_labels;
+    uint64_t num_pairs;
+    const char *record = find_record(name, num_node_labels, num_edge_labels, num_pairs);
+
+    // Records start on an 8-byte boundary, so the pairs are read in place.
+    const unsigned *pairs = (const unsigned*) (record + RECORD_HEADER_SIZE);
+    const char *labels = record + RECORD_HEADER_SIZE + num_pairs * 2 * sizeof(unsigned);
+    string node_labels(labels, num_node_labels);
+    string edge_labels(labels + num_node_labels, num_edge_labels);
+    string source = filename + ":" + name;
+    if (dual)
+        return SimpleHypergraph::dual_from_incidences(node_labels, edge_labels, pairs, num_pairs, source.c_str());
+    return SimpleHypergraph::from_incidences(node_labels, edge_labels, pairs, num_pairs, source.c_str());
+}
+
+void HypergraphContainer::read_labels(const string &name, string &node_labels, string &edge_labels) const  {
+    uint32_t num_node_labels, num_edge_labels;
+    uint64_t num_pairs;
+    const char *record = find_record(name, num_node_labels, num_edge_labels, num_pairs);
+
+    const char *labels = record + RECORD_HEADER_SIZE + num_pairs * 2 * sizeof(unsigned);
+    node_labels.assign(labels, num_node_labels);
+    edge_labels.assign(labels + num_node_labels, num_edge_labels);
+}
+
+
+void HypergraphContainer::write(const string &file, const string &nl_path, const string &el_path, const string &hg_path, const vector<string> &names)  {
+    ofstream out(file.c_str(), ios::out | ios::binary);
+    if (out.fail())  {
+        cerr << "ERROR: Hypergraph container " << file << " could not be opened." << endl; exit(1);
+    }
+
+    char header[HEADER_SIZE];
+    memset(header, 0, HEADER_SIZE);
+    out.write(header, HEADER_SIZE);
+
+    vector<string> packed;
+    vector<pair<uint64_t, uint64_t> > records;
+    set<string> seen;
+    uint64_t offset = HEADER_SIZE;
+    for (unsigned i=0; i<names.size(); i++)  {
+        if (!seen.insert(names[i]).second)
+            continue;
+
+        string nlabels_file = nl_path + "/" + names[i] + ".nlabels";
+        string elabels_file = el_path + "/" + names[i] + ".elabels";
+        string hypergraph_file = hg_path + "/" + names[i] + ".hypergraph";
+        string node_labels, edge_labels;
+        vector<unsigned> pairs;
+        SimpleHypergraph::read_incidences(nlabels_file.c_str(), elabels_file.c_str(), hypergraph_file.c_str(), node_labels, edge_labels, pairs);
+        // Out-of-range ids are reported now rather than when the container is used.
+        SimpleHypergraph::from_incidences(node_labels, edge_labels, pairs.data(), pairs.size() / 2, hypergraph_file.c_str());
+
+        uint32_t num_node_labels = node_labels.size(), num_edge_labels = edge_labels.size();
+        uint64_t num_pairs = pairs.size() / 2;
+        out.write((const char*) &num_node_labels, sizeof(num_node_labels));
+        out.write((const char*) &num_edge_labels, sizeof(num_edge_labels));
+        out.write((const char*) &num_pairs, sizeof(num_pairs));
+        out.write((const char*) pairs.data(), pairs.size() * sizeof(unsigned));
+        out.write(node_labels.data(), node_labels.size());
+        out.write(edge_labels.data(), edge_labels.size());
+        uint64_t record_size = RECORD_HEADER_SIZE + pairs.size() * sizeof(unsigned) + node_labels.size() + edge_labels.size();
+        out.write(header, (8 - record_size % 8) % 8);
+
+        packed.push_back(names[i]);
+        records.push_back(make_pair(offset, record_size));
+        offset += record_size + (8 - record_size % 8) % 8;
+    }
+
+    for (unsigned i=0; i<packed.size(); i++)  {
+        uint32_t name_size = packed[i].size();
+        out.write((const char*) &records[i].first, sizeof(uint64_t));
+        out.write((const char*) &records[i].second, sizeof(uint64_t));
+        out.write((const char*) &name_size, sizeof(name_size));
+        out.write(packed[i].data(), name_size);
+    }
+
+    uint64_t count = packed.size();
+    memcpy(header, CONTAINER_MAGIC, sizeof(CONTAINER_MAGIC));
+    memcpy(header + 4, &CONTAINER_VERSION, sizeof(CONTAINER_VERSION));
+    memcpy(header + 8, &count, sizeof(count));
+    memcpy(header + 16, &offset, sizeof(offset));
+    out.seekp(0);
+    out.write(header, HEADER_SIZE);
+    out.close();
+    if (out.fail())  {
+        cerr << "ERROR: Hypergraph container " << file << " could not be written." << endl; exit(1);
+    }
+}
@@ -0,0 +1,61 @@
+/**
+ * Hypergraph container - a single file holding many example hypergraphs.
+ *
+ * Each hypergraph is stored as one contiguous binary record with its vertex
+ * labels, edge labels and (edge, vertex) pairs, and records are looked up by
+ * name through an index at the end of the file. Integers are stored in the
+ * byte order of the machine that packed the container.
+ *
+ */
+
+
+#ifndef __HYPERGRAPH_CONTAINER_H__
+#define __HYPERGRAPH_CONTAINER_H__
+
+#include "simhypergraph.h"
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+using namespace std;
+
+
+class HypergraphContainer  {
+public:
+    HypergraphContainer() : data(NULL), size(0) {}
+    ~HypergraphContainer()  { close(); }
+
+    /** Maps a container file into memory and reads its index. */
+    void open(const string &file);
+
+    /** Unmaps the container file, if any. */
+    void close();
+
+    inline bool is_open() const  { return data != NULL; }
+
+    /** Returns true if a hypergraph with the given name is stored in the container. */
+    inline bool contains(const string &name) const  { return index.find(name) != index.end(); }
+
+    /** Create the hypergraph (or its dual hypergraph) stored under the given name. */
+    SimpleHypergraph read_hypergraph(const string &name, bool dual) const;
+
+    /** Read the vertex and edge labels of the hypergraph stored under the given name. */
+    void read_labels(const string &name, string &node_labels, string &edge_labels) const;
+
+    /** Packs the named hypergraphs, read from vertex labels, edge labels and hypergraph directories, into a container file. */
+    static void write(const string &file, const string &nl_path, const string &el_path, const string &hg_path, const vector<string> &names);
+
+private:
+    HypergraphContainer(const HypergraphContainer&);
+    HypergraphContainer& operator=(const HypergraphContainer&);
+
+    /** Returns the record of the named hypergraph and the sizes given in its header. */
+    const char* find_record(const string &name, uint32_t &num_node_labels, uint32_t &num_edge_labels, uint64_t &num_pairs) const;
+
+    string filename;
+    const char *data;
+    size_t size;
+    map<string, pair<uint64_t, uint64_t> > index;  // Name to record offset and size.
+};
+
+#endif
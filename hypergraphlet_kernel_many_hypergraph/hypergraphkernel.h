@@ -16,7 +16,10 @@
 
 #include "utils.h"
 #include "simhypergraph.h"
+#include "hypergraphcontainer.h"
+#include "hypergraphprefetcher.h"
 #include <fstream>
+#include <functional>
 #include <utility>
 #include <list>
 #include <map>
@@ -28,12 +31,18 @@ using namespace std;
 
 class HypergraphKernels  {
 public:
-    HypergraphKernels() : NORMALIZE(false), DUALITY(false), VERBOSE(false), SF(0.0), ELM(0), EM(0) {}
+    HypergraphKernels() : NORMALIZE(false), DUALITY(false), VERBOSE(false), KEEP_COUNTS(false), SF(0.0), ELM(0), EM(0), ED(0), LOADERS(1), PREFETCH(8) {}
     ~HypergraphKernels()  {}
      
     /** Read vertex- and edge-labeled hypergraphs (or dual hypergraphs) and a list of vertex of interest. */ 
     void read_hypergraph(string nl_path, string el_path, string hg_path, const vector<string> &hg_filenames, const vector<unsigned> &vertices_of_interest);
 
+    /** Read hypergraphs from a container file (see pack_hypergraphs) instead of the vertex labels, edge labels and hypergraph directories. */
+    void read_container(string container_file);
+
+    /** Sets the codes packed into keys for the labels of the named hypergraphs (or dual hypergraphs) and the label alphabets. */
+    void encode_labels(string nl_path, string el_path, string hg_path, const vector<string> &hg_filenames, string vertex_symbols, string edge_symbols);
+
     /** Read a probability similarity matrix for each vertex label so that one can weight each vertex label substitution. */
     void read_sim_vlm_matrix(string filename);
 
@@ -85,9 +94,21 @@ public:
     /** Compute edit distance (with 2 operations) hypergraph kernel matrix. */
     void compute_edit_distance2_matrix();
 
+    /** Compute edit distance (with up to ED combined operations) hypergraph kernel matrix. */
+    void compute_generalized_edit_distance_matrix();
+
     /** Writes distance kernel matrix in either: 1:triangular binary form, 2:triangular standard output form, 3: squared-matrix standard output form. */
     void write_matrix(const char *file);
 
+    /** Writes the lower triangle of the kernel matrix in binary form (OUTPUT_FORMAT 0). */
+    void write_binary_matrix(const char *file);
+
+    /** Writes the lower triangle of the kernel matrix to standard output form (OUTPUT_FORMAT 1). */
+    void write_triangular_matrix(const char *file);
+
+    /** Writes the squared kernel matrix to standard output form (OUTPUT_FORMAT 2). */
+    void write_square_matrix(const char *file);
+
     /**  */
     void write_sparse_svml_lm(string nl_path, string el_path, string hg_path, const vector<string> &hg_filenames, const vector<unsigned> &vertices_of_interest, const char *file);
 
@@ -100,15 +121,24 @@ public:
     /** */
     void write_sparse_svml_ed2(string nl_path, string el_path, string hg_path, const vector<string> &hg_filenames, const vector<unsigned> &vertices_of_interest, const char *file);
 
+    /** */
+    void write_sparse_svml_ged(string nl_path, string el_path, string hg_path, const vector<string> &hg_filenames, const vector<unsigned> &vertices_of_interest, const char *file);
+
     /** */
     void write_labels(const char *file);
 
-    inline void set_normalize()  { NORMALIZE = true; } 
+    inline void set_normalize(bool normalize = true)  { NORMALIZE = normalize; } 
 
     inline void set_duality()  { DUALITY = true; } 
 
     inline void set_verbose()  { VERBOSE = true; }
 
+    /** Keeps the exact hypergraphlet counts and mismatch neighborhoods of each example so that several kernels can be computed from one enumeration. */
+    inline void set_keep_counts()  { KEEP_COUNTS = true; }
+
+    /** Loads upcoming examples on the given number of background threads, at most depth examples ahead (0 threads loads each example when needed). */
+    inline void set_prefetch(unsigned loaders, unsigned depth)  { LOADERS = loaders; PREFETCH = depth; }
+
     inline void set_number_vertex_label_mismatches(float fraction)  { SF = fraction; }
     
     inline void set_vertex_label_mismatches_alphabet(string alphabet)  { ALPHABET = alphabet; }
@@ -120,8 +150,18 @@ public:
     inline void set_number_edge_label_mismatches(int elm)  { ELM = elm; }
 
 	inline void set_number_edges_mismatches(unsigned edges_mismatches)  { EM = edges_mismatches; }
+
+    inline void set_edit_distance(unsigned edit_distance)  { ED = edit_distance; }
+
+    inline void set_edit_distance_weights(const vector<float> &weights)  { ED_WEIGHTS = weights; }
    
 private:
+    /** Read the named hypergraph (or dual hypergraph) from the container, if any, or else from its files. */
+    SimpleHypergraph load_hypergraph(const string &nl_path, const string &el_path, const string &hg_path, const string &name);
+
+    /** Returns a loader of the i-th named hypergraph (or dual hypergraph), for prefetching. */
+    function<SimpleHypergraph(size_t)> example_loader(const string &nl_path, const string &el_path, const string &hg_path, const vector<string> &hg_filenames);
+
 	/** Returns the cumulative random walk hypergraph kernel between two rooted neighborhoods. */
     float random_walk_cumulative(SimpleHypergraph &hg1, SimpleHypergraph &hg2, unsigned hg1_root, unsigned hg2_root, int steps, double restart);
 
@@ -143,6 +183,9 @@ private:
     /** Returns the counts of labeled hypergraphlets on a rooted neighborhood. */
 	vector<map<Key,MismatchInfo> > get_hypergraphlets_counts(SimpleHypergraph &hg, unsigned hg_root);
 
+    /** Returns the counts of labeled hypergraphlets on the rooted neighborhood of the i-th example. */
+    vector<map<Key,MismatchInfo> > get_root_hypergraphlets_counts(SimpleHypergraph &hg, unsigned hg_root, unsigned i);
+
     /** Adds the counts for inexact hypergraphlets based on vertex label substitutions. */
     void add_vertex_label_mismatch_counts(map<Key,MismatchInfo> &hash, map<Key,MismatchInfo> &mismatch_hash, unsigned long hg_type, int VLM, bool option);
 
@@ -161,6 +204,21 @@ private:
     /** Adds the counts for inexact hypergraphlets based on 2-edge insertions and deletions. */
     void add_2_edge_mismatch_counts(vector<map<Key,MismatchInfo> > &hash);
 
+    /** Returns the feature vector of exact and inexact hypergraphlets within ED combined edit operations. */
+    map<Key,float> get_edit_distance_features(vector<map<Key,MismatchInfo> > &hash);
+
+    /** Forgets the grouping of examples, before the examples of a kernel are counted. */
+    void clear_root_classes();
+
+    /** Groups the i-th example with the first earlier one whose rooted neighborhood is isomorphic, and returns the index of that example (i if there is none). */
+    unsigned group_root(SimpleHypergraph &hg, unsigned hg_root, unsigned i);
+
+    /** Copies the kernel entries of grouped examples from those of the examples they are grouped with. */
+    void copy_grouped_rows();
+
+    /** Clears the cached mismatch neighborhoods, unless they are kept across kernels. */
+    void clear_mismatch_neighborhoods();
+
     /** Normalizes the kernel matrix using the method for normalizing spectral kernel matrices. */
     void normalize_spectral(map<Key,MismatchInfo> &, unsigned long hg_type);
 
@@ -174,23 +232,35 @@ private:
     float distance_hash_join(vector<map<Key,MismatchInfo> >, vector<map<Key,MismatchInfo> >);
 
     // Data members.
-    bool NORMALIZE, DUALITY, VERBOSE;
+    bool NORMALIZE, DUALITY, VERBOSE, KEEP_COUNTS;
     float SF;
 	int ELM;
     unsigned EM;
+    unsigned ED;
+    unsigned LOADERS, PREFETCH;  // Example loader threads and prefetch depth.
+    vector<float> ED_WEIGHTS;
     string ALPHABET;
     string ALPHABET_ROOT;
     string EDGES_ALPHABET;
 
     vector<int>                 labels;
     vector<SimpleHypergraph>    hypergraphs;
+    HypergraphContainer         container;  // Packed hypergraphs, used instead of files when open.
     vector<unsigned>            roots;  // Vertices of interest.
-    map<string,float>           sim_vlm_matrix;    
+    map<string,float>           sim_vlm_matrix;
+    string                  sim_vlm_matrix_file;    
 	map<string,float>           sim_elm_matrix;    
+	string                  sim_elm_matrix_file;
     vector<vector<map<Key,MismatchInfo> > > hashes;
+    vector<vector<map<Key,MismatchInfo> > > exact_hashes;  // Exact counts kept across kernels.
+    vector<bool>            counted;
+    vector<unsigned>        root_class;  // Index of the first example with an isomorphic rooted neighborhood.
+    vector<vector<unsigned> > root_forms;         // Canonical rooted neighborhood of each first example.
+    map<uint64_t, vector<unsigned> > form_buckets;  // First examples by Weisfeiler-Lehman hash of their rooted neighborhood.
     vector<vector<float> >  hyperkernel;
-    map<Key, list<Key> >    vl_mismatch_neighborhood;
-    map<Key, list<Key> >    el_mismatch_neighborhood;
+    map<pair<unsigned long, int>, map<Key, list<Key> > > vl_mismatch_neighborhood;  // Per hypergraphlet type and number of mismatches.
+    map<pair<unsigned long, int>, map<Key, list<Key> > > el_mismatch_neighborhood;
+    map<pair<unsigned long, Key>, vector<EditOperation> > ed_neighborhood;
 };
 
 #endif
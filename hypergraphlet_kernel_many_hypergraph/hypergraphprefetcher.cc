@@ -0,0 +1,57 @@
+#include "hypergraphprefetcher.h"
+#include <algorithm>
+#include <utility>
+
+
+HypergraphPrefetcher::HypergraphPrefetcher(function<SimpleHypergraph(size_t)> load, size_t count, unsigned loaders, unsigned depth)
+    : load(load), count(count), depth(max(depth, 1u)), claimed(0), consumed(0), stopped(false)  {
+    for (unsigned t=0; t<loaders && t<count; t++)
+        threads.push_back(thread(&HypergraphPrefetcher::run, this));
+}
+
+
+HypergraphPrefetcher::~HypergraphPrefetcher()  {
+    {
+        unique_lock<mutex> guard(lock);
+        stopped = true;
+    }
+    changed.notify_all();
+    for (unsigned t=0; t<threads.size(); t++)
+        threads[t].join();
+}
+
+
+void HypergraphPrefetcher::run()  {
+    unique_lock<mutex> guard(lock);
+    while (true)  {
+        // Loaders stay at most depth steps ahead of the consumer.
+        while (!stopped && claimed < count && claimed >= consumed + depth)
+            changed.wait(guard);
+        if (stopped || claimed >= count)
+            return;
+        size_t step = claimed++;
+
+        guard.unlock();
+        SimpleHypergraph hg = load(step);
+        guard.lock();
+
+        ready[step] = move(hg);
+        changed.notify_all();
+    }
+}
+
+
+SimpleHypergraph HypergraphPrefetcher::next()  {
+    if (threads.empty())
+        return load(consumed++);
+
+    unique_lock<mutex> guard(lock);
+    map<size_t, SimpleHypergraph>::iterator it;
+    while ((it = ready.find(consumed)) == ready.end())
+        changed.wait(guard);
+    SimpleHypergraph hg = move(it->second);
+    ready.erase(it);
+    consumed++;
+    changed.notify_all();
+    return hg;
+}
@@ -0,0 +1,51 @@
+/**
+ * Hypergraph prefetcher - loads upcoming example hypergraphs on background
+ * threads while the current one is counted.
+ *
+ * Hypergraphs are consumed strictly in order, and at most a fixed number of
+ * them are loaded ahead of the consumer, so memory stays bounded.
+ *
+ */
+
+
+#ifndef __HYPERGRAPH_PREFETCHER_H__
+#define __HYPERGRAPH_PREFETCHER_H__
+
+#include "simhypergraph.h"
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+
+class HypergraphPrefetcher  {
+public:
+    /** Loads the hypergraphs of steps 0 .. count-1 with the given number of loader threads, at most depth steps ahead. 
+     *  With no loader threads every hypergraph is loaded on demand by next(). */
+    HypergraphPrefetcher(function<SimpleHypergraph(size_t)> load, size_t count, unsigned loaders, unsigned depth);
+    ~HypergraphPrefetcher();
+
+    /** Returns the hypergraph of the next step. */
+    SimpleHypergraph next();
+
+private:
+    HypergraphPrefetcher(const HypergraphPrefetcher&);
+    HypergraphPrefetcher& operator=(const HypergraphPrefetcher&);
+
+    /** Loader thread: claims the next step within the prefetch window and loads it. */
+    void run();
+
+    function<SimpleHypergraph(size_t)> load;
+    size_t count, depth;
+    size_t claimed, consumed;   // Steps handed to loaders, and returned by next().
+    bool stopped;
+    map<size_t, SimpleHypergraph> ready;  // Loaded steps not yet returned.
+    mutex lock;
+    condition_variable changed;
+    vector<thread> threads;
+};
+
+#endif
@@ -0,0 +1,81 @@
+/**
+ * Packs the example hypergraphs of the many-hypergraph layout (one .nlabels,
+ * .elabels and .hypergraph file per example) into a single hypergraph
+ * container that run_hypergraphkernel reads with -C.
+ *
+ */
+
+#include "hypergraphcontainer.h"
+#include "string.h"
+#include <iostream>
+#include <fstream>
+using namespace std;
+
+
+void print_help()  {
+    cout << "Usage: pack_hypergraphs -i FILE -g HG_PATH -l L_PATH -e E_PATH -o CONTAINER [...]\n";
+    cout << "Options:\n\n";
+
+    cout << "  -h         Displays this message.\n\n";
+
+    cout << "  -i FILE    List of examples whose first tab-separated column is a hypergraph name (e.g. the -p and -n files).\n";
+    cout << "             Can be given several times; each hypergraph is packed once.\n\n";
+
+    cout << "  -g HG_PATH Path to hypergraph files.\n";
+    cout << "  -l L_PATH  Path to vertex labels file for input hypergraph files.\n";
+    cout << "  -e E_PATH  Path to edge labels file for input hypergraph files.\n\n";
+
+    cout << "  -o FILE    Output hypergraph container.\n\n";
+
+    cout << "  -v         Verbose (prints progress messages).\n\n";
+}
+
+
+int main(int argc, char* argv[])  {
+    vector<string> list_files;
+    string hg_path, l_path, e_path;
+    string output_file;
+    bool verbose(false);
+
+    // Parse command line arguments.
+    for (int i=1; i<argc && (argv[i])[0] == '-'; i++)  {
+        switch ((argv[i])[1])  {
+            case 'h': print_help(); exit(0);
+            case 'i': i++; list_files.push_back(argv[i]); break;
+            case 'g': i++; hg_path=argv[i]; break;
+            case 'l': i++; l_path=argv[i]; break;
+            case 'e': i++; e_path=argv[i]; break;
+            case 'o': i++; output_file=argv[i]; break;
+            case 'v': verbose=true; break;
+            default:
+                cerr << "ERROR: Unknown option " << argv[i] << endl;
+                print_help();  exit(1);
+        }
+    }
+
+    if (list_files.size() == 0 || output_file.size() == 0)  {
+        cerr << "ERROR: Lists of examples and an output container are required." << endl << endl; print_help(); exit(1);
+    }
+
+    // Read lists of hypergraphs.
+    string line;
+    vector<string> names;
+    for (unsigned f=0; f<list_files.size(); f++)  {
+        ifstream in(list_files[f].c_str(), ios::in);
+        if (in.fail())  {
+            cerr << "ERROR: List file " << list_files[f] << " cannot be opened." << endl; exit(1);
+        }
+        while(getline(in, line))  {
+            vector<string> tokens = split(line, '\t');
+            if (tokens.size() > 0 && strip(tokens[0]).size() > 0)
+                names.push_back(strip(tokens[0]));
+        }
+        in.close();
+    }
+
+    if (verbose)  cerr << "Packing " << names.size() << " examples into " << output_file << " ... ";
+    HypergraphContainer::write(output_file, l_path, e_path, hg_path, names);
+    if (verbose)  cerr << endl;
+
+    exit(0);
+}
@@ -38,14 +38,23 @@ void print_help()  {
     cout << "  -t TYPE    Kernel type (0-Cumulative Random Walk, 1-Standard Random Walk, 2-Standard Hypergraphlet, 3-Label Substitutions Hypergraphlet, 4-Edge Indels Hypergraphlet, 5-Edit Distance Hypergraphlet).\n";
     cout << "             Defaults to standard hypergraphlet.\n\n";
 
-    cout << "  -z TASK    Task type (0-Vertex classification, 1-Edge classification, 2-Link prediction)\n";
-    cout << "             Defaults to vertex classification.\n\n";
+    cout << "  -z TASK    Task type (0-Vertex classification, 1-Edge classification)\n";
+    cout << "             Defaults to vertex classification. Link prediction (2) is only supported by run_hyperkernel over a single hypergraph.\n\n";
 
     cout << "  -p FILE    List of positive (vertices) examples.\n";
     cout << "  -n FILE    List of negative (vertices) examples.\n";
     cout << "  -g HG_PATH Path to hypergraph files.\n";
     cout << "  -l L_PATH  Path to vertex labels file for input hypergraph files.\n\n";
-    cout << "  -e E_PATH  Path to edge labels file for input hypergraph files.\n\n";
+    cout << "  -e E_PATH  Path to edge labels file for input hypergraph files.\n";
+    cout << "             Labels are single characters; up to 31 distinct vertex labels and 31 distinct edge labels over all hypergraphs (counting the -V and -E alphabets) are supported.\n\n";
+
+    cout << "  -C FILE    Hypergraph container built by pack_hypergraphs, read instead of the -g, -l and -e paths.\n\n";
+
+    cout << "  -L LOADERS Number of threads loading upcoming examples while the current one is counted (0 loads each example when needed).\n";
+    cout << "             Defaults to 1.\n\n";
+
+    cout << "  -Q DEPTH   Maximum number of examples loaded ahead of the one being counted.\n";
+    cout << "             Defaults to 8.\n\n";
 
     cout << "  -N         Normalize the kernel matrix.\n";
     cout << "             Defaults to false.\n\n";
@@ -77,92 +86,448 @@ void print_help()  {
     cout << "  -m EDGMIS  Total number of edge insertions or deletions allowed between hypergraphlets. (Needed for Edge Indels and Edit Distance Hypergraph kernels)\n";
     cout << "             Defaults to 0.\n\n";
 
+    cout << "  -d DIST    Total number of edit operations (vertex label substitutions, edge label substitutions and edge indels) allowed between hypergraphlets. (Needed for Edit Distance Hypergraph kernel)\n";
+    cout << "             Explores the combined edit neighborhood in a single pass for any DIST; -K, -M and -m still bound each kind of operation.\n";
+    cout << "             Defaults to 0 (i.e. use the original edit distance implementation with -m operations).\n\n";
+
+    cout << "  -w WEIGHTS Comma-separated weights for hypergraphlets at edit distance 0,1,...,DIST (e.g. 1,0.5,0.25). (Needed for Edit Distance Hypergraph kernel with -d)\n";
+    cout << "             Defaults to 1 for every edit distance.\n\n";
+
     cout << "  -V ALPHA   Vertex labels alphabet over problem statement is defined (i.e. all possible labels for a vertex). (Needed for Label Substitutions and Edit Distance Hypergraph kernels)\n\n";
 
     cout << "  -E ALPHA   Edge labels alphabet over problem statement is defined (i.e. all possible labels for an edge). (Needed for Label Substitutions, Edge Indels and Edit Distance Hypergraph kernels)\n\n";
 
+    cout << "  -F CONFIGS File with one kernel configuration per line, given with the kernel-specific options above (e.g. -t 3 -K 0.34 -M 1 -k LM.dat).\n";
+    cout << "             Exact hypergraphlets are counted once per example and shared by all configurations; options not given on a line default to the command line ones.\n\n";
+
+    cout << "  -G GRID    Grid of kernel-specific options to sweep, given as OPTION=VALUE,VALUE,... separated by semicolons (e.g. \"K=0,0.34;M=1,2;N=0,1\").\n";
+    cout << "             Options t, I, R, S, P, K, M, m, d and N (0 or 1) can be swept. Each kernel configuration is computed for every grid point, and the\n";
+    cout << "             option values are appended to its output file name (e.g. LM_K0.34_M1.dat). Exact counts and mismatch neighborhoods are shared by all points.\n\n";
+
     cout << "  -c LABELS  Output file for each example class label.\n\n";   
+
+    cout << "  -H SIZES   Sizes of the hypergraphlets counted, as digits from 1 to 4 (e.g. 234). Defaults to 1234.\n";
+    cout << "  -X         Counts hypergraphlets without partial decompositions of large hyperedges (no induced subhypergraphs).\n";
+    cout << "  -U         Restricts hypergraphlets from having equivalent hyperedges with the same label.\n";
+    cout << "  -o FORMAT  Kernel matrix output format (0-Triangular binary, 1-Triangular text, 2-Square text). Defaults to square text.\n\n";
    
     cout << "  -v         Verbose (prints progress messages).\n\n"; 
 }
 
-int main(int argc, char* argv[])  {
-    typedef enum kerneltype  {
-        RANDOM_WALK_CUMULATIVE,
-        RANDOM_WALK,
-        STANDARD_GRAPHLET,
-        LABEL_MISMATCH,
-        EDGE_MISMATCH,
-        EDIT_DISTANCE
-     } KernelType;
-
-    typedef enum tasktype  {
-        VERTEX_CLASSIFICATION,
-        EDGE_CLASSIFICATION,
-        LINK_PREDICTION
-    } TaskType;
-
-    typedef enum outformat  {
-        KERNEL,
-        SPARSE_SVML
-     } OutputFormat;
+typedef enum kerneltype  {
+    RANDOM_WALK_CUMULATIVE,
+    RANDOM_WALK,
+    STANDARD_GRAPHLET,
+    LABEL_MISMATCH,
+    EDGE_MISMATCH,
+    EDIT_DISTANCE
+ } KernelType;
+
+typedef enum tasktype  {
+    VERTEX_CLASSIFICATION,
+    EDGE_CLASSIFICATION
+} TaskType;
+
+typedef enum outformat  {
+    KERNEL,
+    SPARSE_SVML
+ } OutputFormat;
+
+// Kernel type, output file and kernel-specific parameters of one hypergraph kernel.
+struct KernelConfig  {
+    OutputFormat format;
+    KernelType hk_type;
+    string output_file;
+
+    // Random Walk Hypergraph kernel Parameters
+    int steps;
+    double restart;
+
+    // Label Substitutions and Edit Distance Hypergraph kernels Parameters
+    float vlabel_mismatches;
+    int elabel_mismatches;
+    string sim_vlm_matrix_file, sim_elm_matrix_file;
+
+    // Edge Indels and and Edit Distance Hypergraph kernels Parameter
+    unsigned edgmis;
+
+    // Generalized Edit Distance Hypergraph kernel Parameters
+    unsigned edit_distance;
+    vector<float> edit_distance_weights;
+
+    bool normalize;
+
+    KernelConfig() : format(KERNEL), hk_type(STANDARD_GRAPHLET), steps(100000), restart(0.3), vlabel_mismatches(0.0), elabel_mismatches(1), edgmis(1), edit_distance(0), normalize(false) {}
+};
+
+// Parses the kernel-specific option at argv[i]. Returns false if it is not a kernel-specific option.
+bool parse_kernel_option(KernelConfig &config, char* argv[], int &i)  {
+    switch ((argv[i])[1])  {
+        case 't': 
+            i++; 
+            switch (to_i(argv[i]))  {
+                case 0:
+                    config.hk_type=RANDOM_WALK_CUMULATIVE;
+                    break;
+                case 1:
+                    config.hk_type=RANDOM_WALK;
+                    break;
+                case 2:
+                    config.hk_type=STANDARD_GRAPHLET;
+                    break;
+                case 3:
+                    config.hk_type=LABEL_MISMATCH;
+                    break;
+                case 4:
+                    config.hk_type=EDGE_MISMATCH;
+                    break;
+                case 5:
+                    config.hk_type=EDIT_DISTANCE;
+                    break;
+                default:
+                    config.hk_type=STANDARD_GRAPHLET;
+            }
+            break;
+        case 'k': i++; config.format=KERNEL; config.output_file=argv[i]; break;
+        case 's': i++; config.format=SPARSE_SVML; config.output_file=argv[i]; break;
+        // Hypergraph kernel-specific parameters                    
+        case 'I': i++; config.steps=to_i(argv[i]); break;
+        case 'R': i++; config.restart=to_f(argv[i]); break;
+
+        case 'S': i++; config.sim_vlm_matrix_file=argv[i]; break;
+        case 'P': i++; config.sim_elm_matrix_file=argv[i]; break;
+        case 'K': 
+            i++; 
+            config.vlabel_mismatches=to_f(argv[i]);
+            if(config.vlabel_mismatches < 0.0 || config.vlabel_mismatches > 1.0)  { 
+                cerr << "ERROR: Fraction of nodes allowed to have vertex label mismatches must be 0<=K<=1, but you entered " << argv[i] << endl;
+                print_help();  exit(1);
+            }
+            break;
+        case 'M':
+            i++;
+            config.elabel_mismatches=to_i(argv[i]);
+            if(config.elabel_mismatches < 0)  {
+                cerr << "ERROR: Total number of edge label mismatches must be non-negative, but you entered " << argv[i] << endl;
+                print_help();  exit(1);
+            }
+            break;
+        case 'm': i++; config.edgmis=to_i(argv[i]); break;
+        case 'd': i++; config.edit_distance=to_i(argv[i]); break;
+        case 'w':
+            i++;
+            {
+                config.edit_distance_weights.clear();
+                vector<string> tokens = split(argv[i], ',');
+                for (unsigned w=0; w<tokens.size(); w++)
+                    config.edit_distance_weights.push_back(to_f(strip(tokens[w])));
+            }
+            break;
+        case 'N': config.normalize=true; break;
+        default:
+            return false;
+    }
+    return true;
+}
+
+// Checks the parameters of a kernel configuration and sets the default similarity matrices.
+void check_kernel_config(KernelConfig &config, const string &vertices_alphabet, const string &root_alphabet)  {
+    if (0 == config.output_file.size())  {
+        cerr << "ERROR: Output file name not specified." << endl;  print_help();  exit(1);
+    }
+
+    // The original label substitutions and edit distance implementations are hard-coded for either 1 or 2 operations.
+    if (!(config.hk_type == EDIT_DISTANCE && config.edit_distance > 0))  {
+        if (config.elabel_mismatches > 2)  {
+            cerr << "ERROR: Total number of edge label mismatches must be either 1 or 2, but you entered " << config.elabel_mismatches << endl;
+            print_help();  exit(1);
+        }
+        if (config.edgmis > 2)  {
+            cerr << "ERROR: Total number of edge insertions and deletions must be either 1 or 2, but you entered " << config.edgmis << endl;
+            print_help();  exit(1);
+        }
+    }
+
+    if (0 == config.sim_vlm_matrix_file.size() && (config.hk_type == LABEL_MISMATCH || config.hk_type == EDIT_DISTANCE))  {
+        //Use default node labels similarity matrix
+        config.sim_vlm_matrix_file = "user_defined.matrix";
+    }
+
+    if (0 == config.sim_elm_matrix_file.size() && (config.hk_type == LABEL_MISMATCH || config.hk_type == EDGE_MISMATCH || config.hk_type == EDIT_DISTANCE))  {
+        //Use default hyperedge labels similarity matrix
+        config.sim_elm_matrix_file = "user_defined.matrix";
+    }
+
+    if ((config.hk_type == LABEL_MISMATCH || config.hk_type == EDIT_DISTANCE) && config.vlabel_mismatches > 0.0 && (0 == vertices_alphabet.size() || 0 == root_alphabet.size()))  {
+        cerr << "ERROR: Alphabet for the vertex labels not specified. It is required for selected hypergraph kernel type." << endl;  print_help();  exit(1);
+    }
+}
+
+// Reads one kernel configuration per line (e.g. "-t 3 -K 0.34 -M 1 -k LM.dat"), starting each one from the command line options.
+vector<KernelConfig> read_kernel_configs(string configs_file, const KernelConfig &defaults)  {
+    vector<KernelConfig> configs;
+    string line;
+
+    ifstream f(configs_file.c_str(), ios::in);
+    if (f.fail())  {
+        cerr << "ERROR: Kernel configurations file " << configs_file << " cannot be opened." << endl;  exit(1);
+    }
+    while(getline(f, line))  {
+        if (line.size() > 0)
+            line = strip(line);
+        if (line.size() == 0 || line[0] == '#')
+            continue;
+
+        vector<string> tokens = split(line, ' ');
+        vector<char*> args;
+        for (unsigned j=0; j<tokens.size(); j++)  {
+            if (tokens[j].size() > 0)
+                tokens[j] = strip(tokens[j]);
+            if (tokens[j].size() > 0)
+                args.push_back(&tokens[j][0]);
+        }
+
+        // Every kernel-specific option but -N takes a value.
+        KernelConfig config(defaults);
+        for (int i=0; i<int(args.size()); i++)  {
+            if ((args[i])[0] != '-' || ((args[i])[1] != 'N' && i+1 >= int(args.size())) || !parse_kernel_option(config, &args[0], i))  {
+                cerr << "ERROR: Invalid kernel configuration option " << args[i] << " in " << configs_file << endl;  exit(1);
+            }
+        }
+        configs.push_back(config);
+    }
+    f.close();
 
+    if (configs.size() == 0)  {
+        cerr << "ERROR: No kernel configurations found in " << configs_file << endl;  exit(1);
+    }
+    return configs;
+}
+
+// Expands each kernel configuration over a grid of kernel-specific options (e.g. "K=0,0.34;M=1,2;N=0,1").
+vector<KernelConfig> expand_kernel_grid(const vector<KernelConfig> &configs, string grid)  {
+    vector<pair<char, vector<string> > > dimensions;
+    unsigned matrix_dimensions = 0;
+
+    vector<string> params = split(grid, ';');
+    for (unsigned j=0; j<params.size(); j++)  {
+        if (params[j].size() > 0)
+            params[j] = strip(params[j]);
+        if (params[j].size() == 0)
+            continue;
+
+        vector<string> tokens = split(params[j], '=');
+        if (tokens.size() == 2 && tokens[0].size() > 0)
+            tokens[0] = strip(tokens[0]);
+        if (tokens.size() != 2 || tokens[0].size() != 1 || string("tIRSPKMmdN").find(tokens[0][0]) == string::npos)  {
+            cerr << "ERROR: Invalid grid parameter " << params[j] << endl;  print_help();  exit(1);
+        }
+
+        vector<string> values;
+        vector<string> value_tokens = split(tokens[1], ',');
+        for (unsigned v=0; v<value_tokens.size(); v++)  {
+            if (value_tokens[v].size() > 0)
+                value_tokens[v] = strip(value_tokens[v]);
+            if (value_tokens[v].size() > 0)
+                values.push_back(value_tokens[v]);
+        }
+        if (values.size() == 0)  {
+            cerr << "ERROR: No values given for grid parameter " << params[j] << endl;  print_help();  exit(1);
+        }
+
+        // Similarity matrices vary slowest, so the mismatch neighborhoods built with each one are reused by all other points.
+        if (tokens[0][0] == 'S' || tokens[0][0] == 'P')  {
+            dimensions.insert(dimensions.begin() + matrix_dimensions, make_pair(tokens[0][0], values));
+            matrix_dimensions++;
+        }
+        else
+            dimensions.push_back(make_pair(tokens[0][0], values));
+    }
+
+    vector<KernelConfig> points(configs);
+    for (unsigned j=0; j<dimensions.size(); j++)  {
+        char option = dimensions[j].first;
+        vector<KernelConfig> expanded;
+
+        for (unsigned p=0; p<points.size(); p++)  {
+            for (unsigned v=0; v<dimensions[j].second.size(); v++)  {
+                string value = dimensions[j].second[v];
+                KernelConfig config(points[p]);
+
+                if (option == 'N')  {
+                    if (value != "0" && value != "1")  {
+                        cerr << "ERROR: Grid values for N must be either 0 or 1, but you entered " << value << endl;  print_help();  exit(1);
+                    }
+                    config.normalize = (value == "1");
+                }
+                else  {
+                    string flag = string("-") + option;
+                    char* args[] = {&flag[0], &value[0]};
+                    int i = 0;
+                    parse_kernel_option(config, args, i);
+                }
+
+                // Similarity matrices are named after their file, without directory and extension.
+                string suffix = value;
+                if (option == 'S' || option == 'P')  {
+                    if (suffix.find_last_of('/') != string::npos)
+                        suffix = suffix.substr(suffix.find_last_of('/') + 1);
+                    if (suffix.find_last_of('.') != string::npos)
+                        suffix = suffix.substr(0, suffix.find_last_of('.'));
+                }
+                suffix = string("_") + option + suffix;
+
+                size_t ext = config.output_file.find_last_of('.');
+                size_t dir = config.output_file.find_last_of('/');
+                if (ext != string::npos && (dir == string::npos || ext > dir))
+                    config.output_file.insert(ext, suffix);
+                else
+                    config.output_file += suffix;
+
+                expanded.push_back(config);
+            }
+        }
+        points = expanded;
+    }
+    return points;
+}
+
+// Computes the hypergraph kernel of the given configuration and writes it to its output file.
+void run_kernel(HypergraphKernels &hk, const KernelConfig &config, TaskType task_type, const string &vertices_alphabet, const string &root_alphabet, const string &edges_alphabet, const string &l_path, const string &e_path, const string &hg_path, const vector<string> &hg_filenames, const vector<unsigned> &roots)  {
+    hk.set_normalize(config.normalize);
+
+    switch (config.hk_type)  {
+        case RANDOM_WALK_CUMULATIVE:
+        case RANDOM_WALK:
+            break;
+        case STANDARD_GRAPHLET:
+            hk.set_number_vertex_label_mismatches(0.0);
+            hk.set_number_edge_label_mismatches(0);
+            break;
+        case LABEL_MISMATCH:
+        case EDIT_DISTANCE:
+            hk.set_number_vertex_label_mismatches(config.vlabel_mismatches);
+            hk.set_number_edge_label_mismatches(config.elabel_mismatches);
+            hk.set_number_edges_mismatches(config.edgmis);
+            hk.set_edit_distance(config.edit_distance);
+            hk.set_edit_distance_weights(config.edit_distance_weights);
+            switch (task_type)  {
+                case VERTEX_CLASSIFICATION:
+                    hk.set_vertex_label_mismatches_alphabet(vertices_alphabet);
+                    hk.set_vertex_label_mismatches_root_alphabet(root_alphabet);
+                    hk.set_edge_label_mismatches_alphabet(edges_alphabet);
+                    hk.read_sim_vlm_matrix(config.sim_vlm_matrix_file);
+                    hk.read_sim_elm_matrix(config.sim_elm_matrix_file);
+                    break;
+                case EDGE_CLASSIFICATION:
+                    hk.set_vertex_label_mismatches_alphabet(edges_alphabet);
+                    hk.set_vertex_label_mismatches_root_alphabet(edges_alphabet);
+                    hk.set_edge_label_mismatches_alphabet(vertices_alphabet);
+                    hk.read_sim_vlm_matrix(config.sim_elm_matrix_file);
+                    hk.read_sim_elm_matrix(config.sim_vlm_matrix_file);
+                    break;
+            }
+            break;
+        case EDGE_MISMATCH:
+            hk.set_number_edges_mismatches(config.edgmis);
+            switch (task_type)  {
+                case VERTEX_CLASSIFICATION:
+                    hk.set_edge_label_mismatches_alphabet(edges_alphabet);
+                    break;
+                case EDGE_CLASSIFICATION:
+                    hk.set_edge_label_mismatches_alphabet(vertices_alphabet);
+                    break;
+            }
+            break;
+    }
+
+    switch (config.format)  {
+        case KERNEL:
+			switch (config.hk_type)  {
+                case RANDOM_WALK_CUMULATIVE:
+                    hk.compute_random_walk_cumulative_matrix(config.steps, config.restart);
+                    break;
+				case RANDOM_WALK:
+					hk.compute_random_walk_matrix(config.steps, config.restart);
+					break;
+				case STANDARD_GRAPHLET:
+				case LABEL_MISMATCH:
+					hk.compute_label_mismatch_matrix();
+                    break;
+                case EDGE_MISMATCH:
+                    hk.compute_edge_mismatch_matrix();
+					break;
+                case EDIT_DISTANCE:
+                    if (config.edit_distance > 0)
+                        hk.compute_generalized_edit_distance_matrix();
+                    // Original implementation is hard-coded for either 1 or 2 edit distance operations.
+                    else if (config.edgmis == 2)
+                        hk.compute_edit_distance2_matrix();
+                    else
+                        hk.compute_edit_distance_matrix();
+                    break;
+			}
+			hk.write_matrix(config.output_file.c_str());
+            break;
+        case SPARSE_SVML:
+            switch (config.hk_type)  {
+                case RANDOM_WALK_CUMULATIVE:
+                    // This is an alternate implementation which is memory-efficient but slower. It only reads the current pair of hypergraphs.
+                    hk.read_and_compute_random_walk_cumulative_matrix(l_path, e_path, hg_path, hg_filenames, roots, config.steps, config.restart);
+                    hk.write_matrix(config.output_file.c_str());
+                    break;
+                case RANDOM_WALK:
+                    // This is an alternate implementation which is memory-efficient but slower. It only reads the current pair of hypergraphs.
+                    hk.read_and_compute_random_walk_matrix(l_path, e_path, hg_path, hg_filenames, roots, config.steps, config.restart);
+                    hk.write_matrix(config.output_file.c_str());
+                    break;
+				case STANDARD_GRAPHLET:
+				case LABEL_MISMATCH:
+					hk.write_sparse_svml_lm(l_path, e_path, hg_path, hg_filenames, roots, config.output_file.c_str());
+                    break;
+                case EDGE_MISMATCH:
+					hk.write_sparse_svml_em(l_path, e_path, hg_path, hg_filenames, roots, config.output_file.c_str());
+                    break;
+                case EDIT_DISTANCE:
+                    if (config.edit_distance > 0)
+                        hk.write_sparse_svml_ged(l_path, e_path, hg_path, hg_filenames, roots, config.output_file.c_str());
+                    // Original edit distance kernel implementation is hard-coded for either 1 or 2 edit operations.
+                    else if (config.edgmis == 2)
+                        hk.write_sparse_svml_ed2(l_path, e_path, hg_path, hg_filenames, roots, config.output_file.c_str());
+                    else
+                        hk.write_sparse_svml_ed(l_path, e_path, hg_path, hg_filenames, roots, config.output_file.c_str()); 
+            }
+    }
+}
+
+int main(int argc, char* argv[])  {
     string pos_file;
     string neg_file;
     string hg_path, l_path, e_path;
-    string output_file;
-    OutputFormat format(KERNEL);
-    KernelType hk_type(STANDARD_GRAPHLET);
+    string container_file;
+    unsigned loaders(1), prefetch(8);
     TaskType task_type(VERTEX_CLASSIFICATION);
     string labels_file;
-    bool normalize(false);
+    string configs_file;
+    string grid;
     bool verbose(false);
 
-    // Random Walk Hypergraph kernel Parameters
-    int steps(100000); 
-    double restart(0.3);
+    // Kernel type, output and hypergraph kernel-specific parameters
+    KernelConfig kernel_config;
 
-    // Label Substitutions and Edit Distance Hypergraph kernels Parameters
-    float vlabel_mismatches(0.0);
-    int elabel_mismatches(1);
-    string vertices_alphabet; 
+    // Label Substitutions and Edit Distance Hypergraph kernels alphabets
+    string vertices_alphabet;
     string root_alphabet;
     string edges_alphabet;
-    string sim_vlm_matrix_file, sim_elm_matrix_file;
-
-    // Edge Indels and and Edit Distance Hypergraph kernels Parameter
-    unsigned edgmis(1);
 
 
     // Parse command line arguments.
     for (int i=1; i<argc && (argv[i])[0] == '-'; i++)  {
+        if (parse_kernel_option(kernel_config, argv, i))
+            continue;
+
         switch ((argv[i])[1])  {
             case 'h': print_help(); exit(0);
-            case 't': 
-                i++; 
-                switch (to_i(argv[i]))  {
-                    case 0:
-                        hk_type=RANDOM_WALK_CUMULATIVE;
-                        break;
-                    case 1:
-                        hk_type=RANDOM_WALK;
-                        break;
-                    case 2:
-                        hk_type=STANDARD_GRAPHLET;
-                        break;
-                    case 3:
-                        hk_type=LABEL_MISMATCH;
-                        break;
-                    case 4:
-                        hk_type=EDGE_MISMATCH;
-                        break;
-                    case 5:
-                        hk_type=EDIT_DISTANCE;
-                        break;
-                    default:
-                        hk_type=STANDARD_GRAPHLET;
-                }
-                break;
             case 'z': 
                 i++;
                 switch (to_i(argv[i]))  {
@@ -173,7 +538,7 @@ int main(int argc, char* argv[])  {
                         task_type=EDGE_CLASSIFICATION;
                         break;
                     case 2:
-                        task_type=LINK_PREDICTION;
+                        cerr << "ERROR: Link prediction is only supported by run_hyperkernel over a single hypergraph." << endl;  exit(1);
                     default:
                         task_type=VERTEX_CLASSIFICATION;
                 }
@@ -183,42 +548,24 @@ int main(int argc, char* argv[])  {
             case 'g': i++; hg_path=argv[i]; break;
             case 'l': i++; l_path=argv[i]; break;
 			case 'e': i++; e_path=argv[i]; break;
-            case 'N': normalize=true; break;            
-            case 'k': i++; format=KERNEL; output_file=argv[i]; break;
-            case 's': i++; format=SPARSE_SVML; output_file=argv[i]; break;
-            // Hypergraph kernel-specific parameters                    
-            case 'I': i++; steps=to_i(argv[i]); break;
-            case 'R': i++; restart=to_f(argv[i]); break;
-
-            case 'S': i++; sim_vlm_matrix_file=argv[i]; break;
-            case 'P': i++; sim_elm_matrix_file=argv[i]; break;
-            case 'K': 
-                i++; 
-                vlabel_mismatches=to_f(argv[i]);
-                if(vlabel_mismatches < 0.0 || vlabel_mismatches > 1.0)  { 
-                    cerr << "ERROR: Fraction of nodes allowed to have vertex label mismatches must be 0<=K<=1, but you entered " << argv[i] << endl;
-                    print_help();  exit(1);
-                }
-                break;
-            case 'M':
-                i++;
-                elabel_mismatches=to_i(argv[i]);
-                if(elabel_mismatches < 0 || elabel_mismatches > 2)  {
-                    cerr << "ERROR: Total number of edge label mismatches must be either 1 or 2, but you entered " << argv[i] << endl;
-                    print_help();  exit(1);
-                }
-                break;
-            case 'm':
-                i++;
-                edgmis=to_i(argv[i]);
-                if(edgmis > 2)  {
-                    cerr << "ERROR: Total number of edge insertions and deletions must be either 1 or 2, but you entered " << argv[i] << endl;
-                    print_help();  exit(1);
-                }
-                break;
+            case 'C': i++; container_file=argv[i]; break;
+            case 'L': i++; loaders=to_i(argv[i]); break;
+            case 'Q': i++; prefetch=to_i(argv[i]); break;
             case 'V': i++; vertices_alphabet=argv[i]; root_alphabet=argv[i]; break;
             case 'E': i++; edges_alphabet=argv[i]; break;
+            case 'F': i++; configs_file=argv[i]; break;
+            case 'G': i++; grid=argv[i]; break;
             case 'c': i++; labels_file=argv[i]; break;
+            case 'H':
+                i++;
+                HYPERGRAPHLETS_1 = strchr(argv[i], '1') != NULL;
+                HYPERGRAPHLETS_2 = strchr(argv[i], '2') != NULL;
+                HYPERGRAPHLETS_3 = strchr(argv[i], '3') != NULL;
+                HYPERGRAPHLETS_4 = strchr(argv[i], '4') != NULL;
+                break;
+            case 'X': ENABLE_INDUCED_HYPERGRAPHLETS=false; break;
+            case 'U': DISABLE_MULTIPLICITY=true; break;
+            case 'o': i++; OUTPUT_FORMAT=to_i(argv[i]); break;
             case 'v': verbose=true; break;
             default: 
                 cerr << "ERROR: Unknown option " << argv[i] << endl;
@@ -226,23 +573,16 @@ int main(int argc, char* argv[])  {
         }
     }
 
-    if (0 == output_file.size())  {
-        cerr << "ERROR: Output file name not specified." << endl;  print_help();  exit(1);
-    }
-
-    if (0 == sim_vlm_matrix_file.size() && (hk_type == LABEL_MISMATCH || hk_type == EDIT_DISTANCE))  {
-        //Use default node labels similarity matrix
-        sim_vlm_matrix_file = "user_defined.matrix";
-    }
-
-    if (0 == sim_elm_matrix_file.size() && (hk_type == LABEL_MISMATCH || hk_type == EDGE_MISMATCH || hk_type == EDIT_DISTANCE))  {
-        //Use default hyperedge labels similarity matrix
-        sim_elm_matrix_file = "user_defined.matrix";
-    }
+    vector<KernelConfig> configs;
+    if (configs_file.size() > 0)
+        configs = read_kernel_configs(configs_file, kernel_config);
+    else
+        configs.push_back(kernel_config);
+    if (grid.size() > 0)
+        configs = expand_kernel_grid(configs, grid);
 
-    if ((hk_type == LABEL_MISMATCH || hk_type == EDIT_DISTANCE) && vlabel_mismatches > 0.0 && (0 == vertices_alphabet.size() || 0 == root_alphabet.size()))  {
-        cerr << "ERROR: Alphabet for the vertex labels not specified. It is required for selected hypergraph kernel type." << endl;  print_help();  exit(1);
-    }
+    for (unsigned c=0; c<configs.size(); c++)
+        check_kernel_config(configs[c], vertices_alphabet, root_alphabet);
 
     HypergraphKernels hk;
 
@@ -284,188 +624,37 @@ int main(int argc, char* argv[])  {
         cerr << "ERROR: Too few vertices of interest." << endl << endl; print_help(); exit(1);
     }
 
-    if (normalize)  hk.set_normalize();
     if (verbose)  hk.set_verbose();
+    if (configs.size() > 1)  hk.set_keep_counts();
     switch (task_type)  {
         case VERTEX_CLASSIFICATION:
             break;
         case EDGE_CLASSIFICATION:
-        case LINK_PREDICTION:
             hk.set_duality();
             break;
     }
     hk.set_labels(labels);
-
-    switch (format)  {
-        case KERNEL:
-			switch (hk_type)  {
-                case RANDOM_WALK_CUMULATIVE:
-                    hk.read_hypergraph(l_path, e_path, hg_path, hg_filenames, roots);
-                    hk.compute_random_walk_cumulative_matrix(steps, restart);
-                    break;
-				case RANDOM_WALK:
-                    hk.read_hypergraph(l_path, e_path, hg_path, hg_filenames, roots);
-					hk.compute_random_walk_matrix(steps, restart);
-					break;
-				case STANDARD_GRAPHLET:
-					hk.set_number_vertex_label_mismatches(0.0);
-                    hk.read_hypergraph(l_path, e_path, hg_path, hg_filenames, roots);
-					hk.compute_label_mismatch_matrix();
-					break;
-				case LABEL_MISMATCH:
-					hk.set_number_vertex_label_mismatches(vlabel_mismatches);
-                    hk.set_number_edge_label_mismatches(elabel_mismatches);
-                    switch (task_type)  {
-                        case VERTEX_CLASSIFICATION:
-                            hk.set_vertex_label_mismatches_alphabet(vertices_alphabet);
-                            hk.set_vertex_label_mismatches_root_alphabet(root_alphabet);
-                            hk.set_edge_label_mismatches_alphabet(edges_alphabet);
-                            hk.read_sim_vlm_matrix(sim_vlm_matrix_file);
-                            hk.read_sim_elm_matrix(sim_elm_matrix_file);
-                            break;
-                        case EDGE_CLASSIFICATION:
-                        case LINK_PREDICTION:
-                            hk.set_vertex_label_mismatches_alphabet(edges_alphabet);
-                            hk.set_vertex_label_mismatches_root_alphabet(edges_alphabet);
-                            hk.set_edge_label_mismatches_alphabet(vertices_alphabet);
-                            hk.read_sim_vlm_matrix(sim_elm_matrix_file);
-                            hk.read_sim_elm_matrix(sim_vlm_matrix_file);
-                            break;
-                    }
-                    hk.read_hypergraph(l_path, e_path, hg_path, hg_filenames, roots);
-					hk.compute_label_mismatch_matrix();
-                    break;
-                case EDGE_MISMATCH:
-					hk.set_number_edges_mismatches(edgmis);
-                    switch (task_type)  {
-                        case VERTEX_CLASSIFICATION:
-                            hk.set_edge_label_mismatches_alphabet(edges_alphabet);
-                            break;
-                        case EDGE_CLASSIFICATION:
-                        case LINK_PREDICTION:
-                            hk.set_edge_label_mismatches_alphabet(vertices_alphabet);
-                            break;
-                    }
-                    hk.read_hypergraph(l_path, e_path, hg_path, hg_filenames, roots);
-                    hk.compute_edge_mismatch_matrix();
-					break;
-                case EDIT_DISTANCE:
-                    hk.set_number_vertex_label_mismatches(vlabel_mismatches);
-                    hk.set_number_edge_label_mismatches(elabel_mismatches);
-                    hk.set_number_edges_mismatches(edgmis);
-                    switch (task_type)  {
-                        case VERTEX_CLASSIFICATION:
-                            hk.set_vertex_label_mismatches_alphabet(vertices_alphabet);
-                            hk.set_vertex_label_mismatches_root_alphabet(root_alphabet);
-                            hk.set_edge_label_mismatches_alphabet(edges_alphabet);
-                            hk.read_sim_vlm_matrix(sim_vlm_matrix_file);
-                            hk.read_sim_elm_matrix(sim_elm_matrix_file);
-                            break;                            
-                        case EDGE_CLASSIFICATION:
-                        case LINK_PREDICTION:
-                            hk.set_vertex_label_mismatches_alphabet(edges_alphabet);
-                            hk.set_vertex_label_mismatches_root_alphabet(edges_alphabet);
-                            hk.set_edge_label_mismatches_alphabet(vertices_alphabet);
-                            hk.read_sim_vlm_matrix(sim_elm_matrix_file);
-                            hk.read_sim_elm_matrix(sim_vlm_matrix_file);
-                            break;
-                    }
-                    // Current implementation is hard-coded for either 1 or 2 edit distance operations.
-                    if (edgmis == 2)  {
-                        hk.read_hypergraph(l_path, e_path, hg_path, hg_filenames, roots);
-                        hk.compute_edit_distance2_matrix();
-                    }
-                    else  {
-                        hk.read_hypergraph(l_path, e_path, hg_path, hg_filenames, roots);
-                        hk.compute_edit_distance_matrix();
-                    }
-                    break;
-			}
-			hk.write_matrix(output_file.c_str());
+    hk.set_prefetch(loaders, prefetch);
+    if (container_file.size() > 0)
+        hk.read_container(container_file);
+    if (task_type == VERTEX_CLASSIFICATION)
+        hk.encode_labels(l_path, e_path, hg_path, hg_filenames, vertices_alphabet, edges_alphabet);
+    else
+        hk.encode_labels(l_path, e_path, hg_path, hg_filenames, edges_alphabet, vertices_alphabet);
+
+    // Hypergraphs are kept in main memory only for kernel matrix outputs.
+    for (unsigned c=0; c<configs.size(); c++)  {
+        if (configs[c].format == KERNEL)  {
+            hk.read_hypergraph(l_path, e_path, hg_path, hg_filenames, roots);
             break;
-        case SPARSE_SVML:
-            switch (hk_type)  {
-                case RANDOM_WALK_CUMULATIVE:
-                    // This is an alternate implementation which is memory-efficient but slower. It only reads the current pair of hypergraphs.
-                    hk.read_and_compute_random_walk_cumulative_matrix(l_path, e_path, hg_path, hg_filenames, roots, steps, restart);
-                    hk.write_matrix(output_file.c_str());
-                    break;
-                case RANDOM_WALK:
-                    // This is an alternate implementation which is memory-efficient but slower. It only reads the current pair of hypergraphs.
-                    hk.read_and_compute_random_walk_matrix(l_path, e_path, hg_path, hg_filenames, roots, steps, restart);
-                    hk.write_matrix(output_file.c_str());
-                    break;
-				case STANDARD_GRAPHLET:
-					hk.set_number_vertex_label_mismatches(0.0);
-					hk.write_sparse_svml_lm(l_path, e_path, hg_path, hg_filenames, roots, output_file.c_str());
-					break;
-				case LABEL_MISMATCH:
-					hk.set_number_vertex_label_mismatches(vlabel_mismatches);
-                    hk.set_number_edge_label_mismatches(elabel_mismatches);
-                    switch (task_type)  {
-                        case VERTEX_CLASSIFICATION:
-                            hk.set_vertex_label_mismatches_alphabet(vertices_alphabet);
-                            hk.set_vertex_label_mismatches_root_alphabet(root_alphabet);
-                            hk.set_edge_label_mismatches_alphabet(edges_alphabet);
-                            hk.read_sim_vlm_matrix(sim_vlm_matrix_file);
-                            hk.read_sim_elm_matrix(sim_elm_matrix_file);
-                            break;
-                        case EDGE_CLASSIFICATION:
-                        case LINK_PREDICTION:
-                            hk.set_vertex_label_mismatches_alphabet(edges_alphabet);
-                            hk.set_vertex_label_mismatches_root_alphabet(edges_alphabet);
-                            hk.set_edge_label_mismatches_alphabet(vertices_alphabet);
-                            hk.read_sim_vlm_matrix(sim_elm_matrix_file);
-                            hk.read_sim_elm_matrix(sim_vlm_matrix_file);
-                            break;
-                    }
-					hk.write_sparse_svml_lm(l_path, e_path, hg_path, hg_filenames, roots, output_file.c_str());
-                    break;
-                case EDGE_MISMATCH:
-					hk.set_number_edges_mismatches(edgmis);
-                    switch (task_type)  {
-                        case VERTEX_CLASSIFICATION:
-                            hk.set_edge_label_mismatches_alphabet(edges_alphabet);
-                            break;
-                        case EDGE_CLASSIFICATION:
-                        case LINK_PREDICTION:
-                            hk.set_edge_label_mismatches_alphabet(vertices_alphabet);
-                            break;
-                    }                    
-					hk.write_sparse_svml_em(l_path, e_path, hg_path, hg_filenames, roots, output_file.c_str());
-                    break;
-                case EDIT_DISTANCE:
-                    hk.set_number_vertex_label_mismatches(vlabel_mismatches);
-                    hk.set_number_edge_label_mismatches(elabel_mismatches);
-                    hk.set_number_edges_mismatches(edgmis);
-                    switch (task_type)  {
-                        case VERTEX_CLASSIFICATION:
-                            hk.set_vertex_label_mismatches_alphabet(vertices_alphabet);
-                            hk.set_vertex_label_mismatches_root_alphabet(root_alphabet);
-                            hk.set_edge_label_mismatches_alphabet(edges_alphabet);
-                            hk.read_sim_vlm_matrix(sim_vlm_matrix_file);
-                            hk.read_sim_elm_matrix(sim_elm_matrix_file);
-                            break;
-                        case EDGE_CLASSIFICATION:
-                        case LINK_PREDICTION:
-                            hk.set_vertex_label_mismatches_alphabet(edges_alphabet);
-                            hk.set_vertex_label_mismatches_root_alphabet(edges_alphabet);
-                            hk.set_edge_label_mismatches_alphabet(vertices_alphabet);
-                            hk.read_sim_vlm_matrix(sim_elm_matrix_file);
-                            hk.read_sim_elm_matrix(sim_vlm_matrix_file);
-                            break;
-                    }
-                    // Current edit distance kernel implementation is hard-coded for either 1 or 2 edit operations.
-                    if (edgmis == 2)
-                        hk.write_sparse_svml_ed2(l_path, e_path, hg_path, hg_filenames, roots, output_file.c_str());
-                    else
-                        hk.write_sparse_svml_ed(l_path, e_path, hg_path, hg_filenames, roots, output_file.c_str()); 
-            }
+        }
     }
 
+    for (unsigned c=0; c<configs.size(); c++)
+        run_kernel(hk, configs[c], task_type, vertices_alphabet, root_alphabet, edges_alphabet, l_path, e_path, hg_path, hg_filenames, roots);
+
     if (labels_file.size() > 0)
         hk.write_labels(labels_file.c_str());
 
     exit(0);
 }
-
@@ -3,6 +3,7 @@
 #include <fstream>
 #include <set>
 #include <queue>
+#include <algorithm>
 
 
 vector<unsigned> SimpleHypergraph::get_incident_edges(unsigned vertex)  {
@@ -13,10 +14,9 @@ vector<unsigned> SimpleHypergraph::get_incident_edges(unsigned vertex)  {
 }
 
 
-SimpleHypergraph SimpleHypergraph::read_hypergraph(const char *nlabels_file, const char *elabels_file, const char *hypergraph_file)  {
+void SimpleHypergraph::read_labels(const char *nlabels_file, const char *elabels_file, string &node_labels, string &edge_labels)  {
     ifstream nlin(nlabels_file, ios::in);
 	ifstream elin(elabels_file, ios::in);
-    ifstream hgin(hypergraph_file, ios::in);
 
     if (nlin.fail())  {
         cerr << "ERROR: Hypergraph vertex labels  file " << nlabels_file << " could not be opened." << endl; exit(1);
@@ -26,130 +26,130 @@ SimpleHypergraph SimpleHypergraph::read_hypergraph(const char *nlabels_file, con
         cerr << "ERROR: Hypergraph edge labels  file " << elabels_file << " could not be opened." << endl; exit(1);
     }
 
-    if (hgin.fail())  {
-        cerr << "ERROR: Hypergraph file " << hypergraph_file << " could not be opened." << endl; exit(1);
-    }
-
-    SimpleHypergraph hg;
-    
     // Read hypergraph node labels
     string line;
     if (getline(nlin,line))
-        hg.node_labels = strip(line);
+        node_labels = strip(line);
 
     // Read hypergraph edge labels
     if (getline(elin,line))
-        hg.edge_labels = strip(line);
+        edge_labels = strip(line);
+}
 
-    // Set size of input hypergraph
-    hg.vertex_set.resize(hg.edge_labels.size());
-    hg.edge_set.resize(hg.node_labels.size());
+void SimpleHypergraph::read_incidences(const char *nlabels_file, const char *elabels_file, const char *hypergraph_file, string &node_labels, string &edge_labels, vector<unsigned> &incidences)  {
+    read_labels(nlabels_file, elabels_file, node_labels, edge_labels);
 
-    // Read hypergraph
+    ifstream hgin(hypergraph_file, ios::in);
+    if (hgin.fail())  {
+        cerr << "ERROR: Hypergraph file " << hypergraph_file << " could not be opened." << endl; exit(1);
+    }
+
+    // Read hypergraph as (edge, vertex) pairs in file order
+    string line;
 	while(getline(hgin, line))  {
         vector<string> tokens = split(line, '\t');
         unsigned edge = to_i(tokens[0]); // edge id
-        
+
         // Parse vertex set list
         for (unsigned i=1; i<tokens.size(); i++)  {
-            unsigned vertex = to_i(tokens[i]); // vertex id
-            
-            if (vertex >= hg.node_labels.size())  {
-                cerr << "ERROR: Node index " << vertex << " >= hypergraph nodes size " << hg.node_labels.size() << " in target hypergraph file " << hypergraph_file << "." << endl; exit(1);
-            }
-
-            if (edge >= hg.vertex_set.size()) {
-                cerr << "ERROR: Edge index " << edge << " >= hypergraph edges size " << hg.vertex_set.size() << " in target hypergraph file " << hypergraph_file << "." << endl; exit(1);
-            }
-
-            hg.vertex_set[edge].push_back(vertex);
-            hg.edge_set[vertex].push_back(edge);
+            incidences.push_back(edge);
+            incidences.push_back(to_i(tokens[i])); // vertex id
         }
     }
-    return hg;
 }
 
 
-SimpleHypergraph SimpleHypergraph::read_dual_hypergraph(const char *nlabels_file, const char *elabels_file, const char *hypergraph_file)  {
-    ifstream nlin(nlabels_file, ios::in);
-    ifstream elin(elabels_file, ios::in);
-    ifstream hgin(hypergraph_file, ios::in);
+SimpleHypergraph SimpleHypergraph::from_incidences(const string &node_labels, const string &edge_labels, const unsigned *incidences, size_t num_incidences, const char *source)  {
+    SimpleHypergraph hg;
+    hg.node_labels = node_labels;
+    hg.edge_labels = edge_labels;
 
-    if (nlin.fail())  {
-        cerr << "ERROR: Hypergraph vertex labels  file " << nlabels_file << " could not be opened." << endl; exit(1);
-    }
+    // Set size of input hypergraph
+    hg.vertex_set.resize(hg.edge_labels.size());
+    hg.edge_set.resize(hg.node_labels.size());
 
-    if (elin.fail())  {
-        cerr << "ERROR: Hypergraph edge labels  file " << elabels_file << " could not be opened." << endl; exit(1);
-    }
+    for (size_t i=0; i<num_incidences; i++)  {
+        unsigned edge = incidences[2*i];
+        unsigned vertex = incidences[2*i+1];
 
-    if (hgin.fail())  {
-        cerr << "ERROR: Hypergraph file " << hypergraph_file << " could not be opened." << endl; exit(1);
-    }
+        if (vertex >= hg.node_labels.size())  {
+            cerr << "ERROR: Node index " << vertex << " >= hypergraph nodes size " << hg.node_labels.size() << " in target hypergraph file " << source << "." << endl; exit(1);
+        }
 
-    SimpleHypergraph hg, dual_hg;
+        if (edge >= hg.vertex_set.size()) {
+            cerr << "ERROR: Edge index " << edge << " >= hypergraph edges size " << hg.vertex_set.size() << " in target hypergraph file " << source << "." << endl; exit(1);
+        }
 
-    // Read hypergraph node labels and set dual hypergraph edge labels
-    string line;
-    if (getline(nlin,line))  { 
-        hg.node_labels = strip(line);
-        dual_hg.edge_labels = strip(line);
-    }
-        
-    // Read hypergraph edge labels and set dual hypergraph node labels
-    if (getline(elin,line))  {
-        hg.edge_labels = strip(line);
-        dual_hg.node_labels = strip(line);
+        hg.vertex_set[edge].push_back(vertex);
+        hg.edge_set[vertex].push_back(edge);
     }
+    return hg;
+}
+
+
+SimpleHypergraph SimpleHypergraph::dual_from_incidences(const string &node_labels, const string &edge_labels, const unsigned *incidences, size_t num_incidences, const char *source)  {
+    // The dual is built directly with the roles of vertices and hyperedges swapped, without building the input hypergraph first.
+    SimpleHypergraph dual_hg;
+
+    // Hypergraph node labels are the dual hypergraph edge labels, and vice versa
+    dual_hg.edge_labels = node_labels;
+    dual_hg.node_labels = edge_labels;
 
-    // Set size of input hypergraph
-    hg.vertex_set.resize(hg.edge_labels.size());
-    hg.edge_set.resize(hg.node_labels.size());
-    
     // Set size of dual hypergraph
     dual_hg.vertex_set.resize(dual_hg.edge_labels.size());
     dual_hg.edge_set.resize(dual_hg.node_labels.size());
 
-    // Read hypergraph
-	while(getline(hgin, line))  {
-        vector<string> tokens = split(line, '\t');
-        unsigned edge = to_i(tokens[0]); // edge id
-		
-		// Parse vertex set list
-        for (unsigned i=1; i<tokens.size(); i++)  {
-            unsigned vertex = to_i(tokens[i]); // vertex id
-
-            if (vertex >= hg.node_labels.size())  {
-                cerr << "ERROR: Node index " << vertex << " >= hypergraph nodes size " << hg.node_labels.size() << " in target hypergraph file " << hypergraph_file << "." << endl; exit(1);
-            }
+    // Each edge is a dual vertex, contained in the dual hyperedge of each of its vertices
+    for (size_t i=0; i<num_incidences; i++)  {
+        unsigned edge = incidences[2*i];
+        unsigned vertex = incidences[2*i+1];
 
-            if (edge >= hg.vertex_set.size()) {
-                cerr << "ERROR: Edge index " << edge << " >= hypergraph edges size " << hg.vertex_set.size() << " in target hypergraph file " << hypergraph_file << "." << endl; exit(1);
-            }
+        if (vertex >= dual_hg.vertex_set.size())  {
+            cerr << "ERROR: Node index " << vertex << " >= hypergraph nodes size " << dual_hg.vertex_set.size() << " in target hypergraph file " << source << "." << endl; exit(1);
+        }
 
-            hg.vertex_set[edge].push_back(vertex);
-            hg.edge_set[vertex].push_back(edge);
+        if (edge >= dual_hg.edge_set.size()) {
+            cerr << "ERROR: Edge index " << edge << " >= hypergraph edges size " << dual_hg.edge_set.size() << " in target hypergraph file " << source << "." << endl; exit(1);
         }
+
+        dual_hg.vertex_set[vertex].push_back(edge);
+        dual_hg.edge_set[edge].push_back(vertex);
     }
 
-    // Generate dual hypergraph
-    for (unsigned epsilon=0; epsilon<hg.edge_set.size(); epsilon++)  {  // Iterate over input hypergraph nodes which are dual hypergraph hyperedges
-        for (unsigned e_i=0; e_i<hg.edge_set[epsilon].size(); e_i++)  {
-            unsigned edge = hg.edge_set[epsilon][e_i];
-            dual_hg.vertex_set[epsilon].push_back(edge);
-            dual_hg.edge_set[edge].push_back(epsilon);
-            if (hg.edge_set[epsilon].size() == 1)  {
-                dual_hg.node_labels.push_back(dual_hg.node_labels[edge]);
-                dual_hg.edge_set.resize(dual_hg.node_labels.size());
-                dual_hg.vertex_set[epsilon].push_back(dual_hg.node_labels.size() - 1);
-                dual_hg.edge_set[(dual_hg.node_labels.size() - 1)].push_back(epsilon);
-            }
+    // Keep the dual hyperedges of each dual vertex in increasing order, as if generated from the input hypergraph nodes.
+    for (unsigned edge=0; edge<dual_hg.edge_set.size(); edge++)
+        sort(dual_hg.edge_set[edge].begin(), dual_hg.edge_set[edge].end());
+
+    // Dual hyperedges with a single vertex get a copy of that vertex
+    for (unsigned epsilon=0; epsilon<dual_hg.vertex_set.size(); epsilon++)  {
+        if (dual_hg.vertex_set[epsilon].size() == 1)  {
+            unsigned edge = dual_hg.vertex_set[epsilon][0];
+            dual_hg.node_labels.push_back(dual_hg.node_labels[edge]);
+            dual_hg.edge_set.resize(dual_hg.node_labels.size());
+            dual_hg.vertex_set[epsilon].push_back(dual_hg.node_labels.size() - 1);
+            dual_hg.edge_set[(dual_hg.node_labels.size() - 1)].push_back(epsilon);
         }
     }
     return dual_hg;
 }
 
 
+SimpleHypergraph SimpleHypergraph::read_hypergraph(const char *nlabels_file, const char *elabels_file, const char *hypergraph_file)  {
+    string node_labels, edge_labels;
+    vector<unsigned> incidences;
+    read_incidences(nlabels_file, elabels_file, hypergraph_file, node_labels, edge_labels, incidences);
+    return from_incidences(node_labels, edge_labels, incidences.data(), incidences.size() / 2, hypergraph_file);
+}
+
+
+SimpleHypergraph SimpleHypergraph::read_dual_hypergraph(const char *nlabels_file, const char *elabels_file, const char *hypergraph_file)  {
+    string node_labels, edge_labels;
+    vector<unsigned> incidences;
+    read_incidences(nlabels_file, elabels_file, hypergraph_file, node_labels, edge_labels, incidences);
+    return dual_from_incidences(node_labels, edge_labels, incidences.data(), incidences.size() / 2, hypergraph_file);
+}
+
+
 void SimpleHypergraph::print_hypergraph(const char* nlabels_filename, const char* elabels_filename, const char* hypergraph_filename)  {
     ofstream nlabels_file(nlabels_filename, ios::out);
     // Output vertex labels for hypergraph
@@ -295,3 +295,135 @@ vector<set<unsigned> > SimpleHypergraph::get_neighbors() const  {
     }
     return neighbors;
 }
+
+
+static inline uint64_t fnv_step(uint64_t h, uint64_t value)  {
+    return (h ^ value) * 1099511628211ULL;
+}
+
+static unsigned count_colors(vector<uint64_t> colors)  {
+    sort(colors.begin(), colors.end());
+    return unique(colors.begin(), colors.end()) - colors.begin();
+}
+
+// Refines vertex colors by the colors of their incident hyperedges, each given by its label, size and the colors of its
+// members, until the number of colors stops growing; returns that number.
+static unsigned refine_colors(vector<uint64_t> &colors, const vector<vector<unsigned> > &vertex_edges, const vector<vector<unsigned> > &edge_members, const vector<uint64_t> &edge_base)  {
+    unsigned num_colors = count_colors(colors);
+    vector<uint64_t> edge_colors(edge_members.size()), next(colors.size()), multiset;
+
+    while (true)  {
+        for (unsigned e=0; e<edge_members.size(); e++)  {
+            multiset.clear();
+            for (unsigned m=0; m<edge_members[e].size(); m++)
+                multiset.push_back(colors[edge_members[e][m]]);
+            sort(multiset.begin(), multiset.end());
+            edge_colors[e] = edge_base[e];
+            for (unsigned m=0; m<multiset.size(); m++)
+                edge_colors[e] = fnv_step(edge_colors[e], multiset[m]);
+        }
+        for (unsigned v=0; v<colors.size(); v++)  {
+            multiset.clear();
+            for (unsigned m=0; m<vertex_edges[v].size(); m++)
+                multiset.push_back(edge_colors[vertex_edges[v][m]]);
+            sort(multiset.begin(), multiset.end());
+            next[v] = fnv_step(14695981039346656037ULL, colors[v]);
+            for (unsigned m=0; m<multiset.size(); m++)
+                next[v] = fnv_step(next[v], multiset[m]);
+        }
+        colors.swap(next);
+
+        unsigned refined = count_colors(colors);
+        if (refined == num_colors)
+            return num_colors;
+        num_colors = refined;
+    }
+}
+
+// Hypergraphlets of a root only reach vertices within 3 hops, their hyperedges and the sizes of those hyperedges, so the
+// form holds the labels of these vertices and the label, size and members within 3 hops of each hyperedge, in an order
+// given by Weisfeiler-Lehman colors. Ties left by refinement are broken by singling out the first vertex of the
+// smallest tied color and refining again, which may part isomorphic neighborhoods but never joins others.
+vector<unsigned> SimpleHypergraph::get_rooted_form(unsigned hg_root, uint64_t &wl_hash) const  {
+    vector<unsigned> dist = breadth_first_sort(hg_root);
+    vector<unsigned> ball(1, hg_root), local(node_labels.size(), UINT_MAX);
+    local[hg_root] = 0;
+    for (unsigned v=0; v<node_labels.size(); v++)  {
+        if (dist[v] != UINT_MAX && v != hg_root)  {
+            local[v] = ball.size();
+            ball.push_back(v);
+        }
+    }
+
+    vector<vector<unsigned> > vertex_edges(ball.size()), edge_members;
+    vector<uint64_t> edge_base;
+    vector<unsigned> edges, edge_index(vertex_set.size(), UINT_MAX);
+    for (unsigned v=0; v<ball.size(); v++)  {
+        for (unsigned j=0; j<edge_set[ball[v]].size(); j++)  {
+            unsigned e = edge_set[ball[v]][j];
+            if (edge_index[e] == UINT_MAX)  {
+                edge_index[e] = edges.size();
+                edges.push_back(e);
+                edge_members.push_back(vector<unsigned>());
+                edge_base.push_back(fnv_step(fnv_step(14695981039346656037ULL, (unsigned char) edge_labels[e]), vertex_set[e].size()));
+                for (unsigned k=0; k<vertex_set[e].size(); k++)  {
+                    if (local[vertex_set[e][k]] != UINT_MAX)
+                        edge_members.back().push_back(local[vertex_set[e][k]]);
+                }
+            }
+            vertex_edges[v].push_back(edge_index[e]);
+        }
+    }
+
+    // The root is the only vertex at distance 0, so it keeps a color of its own.
+    vector<uint64_t> colors(ball.size());
+    for (unsigned v=0; v<ball.size(); v++)
+        colors[v] = fnv_step(fnv_step(14695981039346656037ULL, (unsigned char) node_labels[ball[v]]), dist[ball[v]]);
+    unsigned num_colors = refine_colors(colors, vertex_edges, edge_members, edge_base);
+
+    vector<uint64_t> sorted_colors(colors);
+    sort(sorted_colors.begin(), sorted_colors.end());
+    wl_hash = fnv_step(14695981039346656037ULL, edges.size());
+    for (unsigned v=0; v<sorted_colors.size(); v++)
+        wl_hash = fnv_step(wl_hash, sorted_colors[v]);
+
+    vector<pair<uint64_t, unsigned> > order(ball.size());
+    for (unsigned singled_out=0; num_colors < ball.size() && singled_out < ball.size(); singled_out++)  {
+        for (unsigned v=0; v<ball.size(); v++)
+            order[v] = make_pair(colors[v], v);
+        sort(order.begin(), order.end());
+        unsigned t(1);
+        while (order[t].first != order[t-1].first)
+            t++;
+        colors[order[t-1].second] = fnv_step(colors[order[t-1].second], ball.size());
+        num_colors = refine_colors(colors, vertex_edges, edge_members, edge_base);
+    }
+
+    // Position of each vertex in the form: the root first, then the others by color.
+    for (unsigned v=0; v<ball.size(); v++)
+        order[v] = make_pair(v == 0 ? 0 : colors[v], v);
+    sort(order.begin() + 1, order.end());
+    vector<unsigned> position(ball.size());
+    for (unsigned p=0; p<ball.size(); p++)
+        position[order[p].second] = p;
+
+    vector<unsigned> form;
+    form.push_back(ball.size());
+    form.push_back(edges.size());
+    for (unsigned p=0; p<ball.size(); p++)
+        form.push_back((unsigned char) node_labels[ball[order[p].second]]);
+
+    vector<vector<unsigned> > edge_forms(edges.size());
+    for (unsigned e=0; e<edges.size(); e++)  {
+        edge_forms[e].push_back((unsigned char) edge_labels[edges[e]]);
+        edge_forms[e].push_back(vertex_set[edges[e]].size());
+        edge_forms[e].push_back(edge_members[e].size());
+        for (unsigned m=0; m<edge_members[e].size(); m++)
+            edge_forms[e].push_back(position[edge_members[e][m]]);
+        sort(edge_forms[e].begin() + 3, edge_forms[e].end());
+    }
+    sort(edge_forms.begin(), edge_forms.end());
+    for (unsigned e=0; e<edge_forms.size(); e++)
+        form.insert(form.end(), edge_forms[e].begin(), edge_forms[e].end());
+    return form;
+}
@@ -18,6 +18,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <limits.h>
+#include <stdint.h>
 #include <iostream>
 #include <vector>
 #include <list>
@@ -39,6 +40,18 @@ public:
     /** Read a target file and create a dual hypergraph from input hypergraph. */
     static SimpleHypergraph read_dual_hypergraph(const char*, const char*, const char*);
 
+    /** Read the vertex and edge labels of a target hypergraph. */
+    static void read_labels(const char*, const char*, string&, string&);
+
+    /** Read the labels and the (edge, vertex) pairs, in file order, of a target hypergraph. */
+    static void read_incidences(const char*, const char*, const char*, string&, string&, vector<unsigned>&);
+
+    /** Create a hypergraph from its labels and (edge, vertex) pairs. */
+    static SimpleHypergraph from_incidences(const string&, const string&, const unsigned*, size_t, const char*);
+
+    /** Create a dual hypergraph from the labels and (edge, vertex) pairs of the input hypergraph. */
+    static SimpleHypergraph dual_from_incidences(const string&, const string&, const unsigned*, size_t, const char*);
+
     /** Prints a hypergraph into corresponding user-speified files. */
     void print_hypergraph(const char*, const char*, const char*);
 
@@ -54,6 +67,10 @@ public:
     /** Gets neighboring nodes for each node in a hypergraph. */
     vector<set<unsigned> > get_neighbors() const;
 
+    /** Canonical form of the labeled neighborhood within 3 hops of a vertex, and its Weisfeiler-Lehman hash.
+     *  Isomorphic neighborhoods hash alike, and neighborhoods with equal forms are isomorphic. */
+    vector<unsigned> get_rooted_form(unsigned, uint64_t&) const;
+
 
     string node_labels;                     // Vertex (or node) labels.
 	string edge_labels;					    // Hyperedge labels.
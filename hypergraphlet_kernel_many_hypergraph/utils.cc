@@ -8,6 +8,13 @@
 #include <iomanip>
 using namespace std;
 
+bool HYPERGRAPHLETS_1(DEFAULT_HYPERGRAPHLETS_1), HYPERGRAPHLETS_2(DEFAULT_HYPERGRAPHLETS_2), HYPERGRAPHLETS_3(DEFAULT_HYPERGRAPHLETS_3), HYPERGRAPHLETS_4(DEFAULT_HYPERGRAPHLETS_4);
+bool ENABLE_INDUCED_HYPERGRAPHLETS(DEFAULT_ENABLE_INDUCED_HYPERGRAPHLETS);
+bool DISABLE_MULTIPLICITY(DEFAULT_DISABLE_MULTIPLICITY);
+int OUTPUT_FORMAT(DEFAULT_OUTPUT_FORMAT);
+unsigned char NODE_LABEL_CODE[256], EDGE_LABEL_CODE[256];
+char NODE_CODE_LABEL[NODES_ALPHABET_SIZE+1], EDGE_CODE_LABEL[HYPEREDGES_ALPHABET_SIZE+1];
+
 
 /************************ Auxiliary functions for Hypergraph Kernel class *************************/
 float compare_labels(char label1, char label2)  {
@@ -157,12 +164,12 @@ void insert_permutation(const Key &target, vector<Key> &mismatches_list)  {
 /* This function inserts a hyperedge label into a vector of hyperedge labels. However, if DISABLE_MULTIPLICITY flag is on, it first checks
  if label is already listed. */
 void insert_hyperedge_label(const char &hyperedge_label, vector<char> &hyperedge_labels)  {
-    #if DISABLE_MULTIPLICITY == 1
-    for (vector<char>::iterator hyperedge_key = hyperedge_labels.begin(); hyperedge_key < hyperedge_labels.end(); hyperedge_key++)  {
-        if (*hyperedge_key == hyperedge_label)
-            return;
+    if (DISABLE_MULTIPLICITY)  {
+        for (vector<char>::iterator hyperedge_key = hyperedge_labels.begin(); hyperedge_key < hyperedge_labels.end(); hyperedge_key++)  {
+            if (*hyperedge_key == hyperedge_label)
+                return;
+        }
     }
-    #endif
     hyperedge_labels.push_back(hyperedge_label);
 }
 
@@ -175,12 +182,56 @@ bool search_hyperedge_label(const char &hyperedge_label, vector<char> &hyperedge
     return false;
 }
 
+/* This function sets the codes of one label kind. Labels between ZERO_CHAR and ZERO_CHAR+alphabet_size keep their offset
+   from ZERO_CHAR, so keys and outputs do not change; otherwise the labels in use get dense codes in their sorted order.
+   Returns true if the labels were remapped. */
+static bool assign_codes(const string &symbols, unsigned alphabet_size, unsigned char *label_code, char *code_label, const char *kind)  {
+    vector<bool> used(256, false);
+    bool remap = false;
+    for (unsigned i=0; i<symbols.size(); i++)  {
+        unsigned char c = symbols[i];
+        if (c == ZERO_CHAR)
+            continue;
+        used[c] = true;
+        if (c <= ZERO_CHAR || c > ZERO_CHAR + alphabet_size)
+            remap = true;
+    }
+
+    fill(label_code, label_code + 256, 0);
+    fill(code_label, code_label + alphabet_size + 1, ZERO_CHAR);
+    if (!remap)  {
+        for (unsigned code=0; code<=alphabet_size; code++)  {
+            label_code[ZERO_CHAR + code] = code;
+            code_label[code] = ZERO_CHAR + code;
+        }
+        return false;
+    }
+
+    unsigned code = 0;
+    for (unsigned c=0; c<256; c++)  {
+        if (!used[c])
+            continue;
+        if (++code > alphabet_size)  {
+            cerr << "ERROR: More than " << alphabet_size << " distinct " << kind << " labels." << endl; exit(1);
+        }
+        label_code[c] = code;
+        code_label[code] = c;
+    }
+    return true;
+}
+
+bool assign_label_codes(const string &node_symbols, const string &edge_symbols)  {
+    bool remap_nodes = assign_codes(node_symbols, NODES_ALPHABET_SIZE, NODE_LABEL_CODE, NODE_CODE_LABEL, "vertex");
+    bool remap_edges = assign_codes(edge_symbols, HYPEREDGES_ALPHABET_SIZE, EDGE_LABEL_CODE, EDGE_CODE_LABEL, "edge");
+    return remap_nodes || remap_edges;
+}
+
 string get_nkey(Element k)  {	
 	string temp(NODES_MAX_SIZE,ZERO_CHAR); 
     for (unsigned i=NODES_MAX_SIZE-1; i > 0; i--)  {
-        temp[i] = (k & NODES_ALPHABET_SIZE) + ZERO_CHAR; k = k >> LOG_NODES_ALPHABET_SIZE;
+        temp[i] = NODE_CODE_LABEL[k & NODES_ALPHABET_SIZE]; k = k >> LOG_NODES_ALPHABET_SIZE;
     }
-    temp[0] = (k & NODES_ALPHABET_SIZE) + ZERO_CHAR; //root
+    temp[0] = NODE_CODE_LABEL[k & NODES_ALPHABET_SIZE]; //root
 	
     return temp;
 }
@@ -188,9 +239,9 @@ string get_nkey(Element k)  {
 string get_ekey(Element k)  {
 	string temp(HYPEREDGES_MAX_SIZE,ZERO_CHAR);
     for (unsigned i=HYPEREDGES_MAX_SIZE-1; i > 0; i--)  {
-        temp[i] = (k & HYPEREDGES_ALPHABET_SIZE) + ZERO_CHAR; k = k >> LOG_HYPEREDGES_ALPHABET_SIZE;
+        temp[i] = EDGE_CODE_LABEL[k & HYPEREDGES_ALPHABET_SIZE]; k = k >> LOG_HYPEREDGES_ALPHABET_SIZE;
     }
-    temp[0] = (k & HYPEREDGES_ALPHABET_SIZE) + ZERO_CHAR; //e1
+    temp[0] = EDGE_CODE_LABEL[k & HYPEREDGES_ALPHABET_SIZE]; //e1
 	
     return temp;
 }
@@ -198,9 +249,9 @@ string get_ekey(Element k)  {
 string print_nkey(Element k)  {
 	string temp(NODES_MAX_SIZE,ZERO_CHAR);
     for (unsigned i=NODES_MAX_SIZE-1; i > 0; i--)  {
-        temp[i] = (k & NODES_ALPHABET_SIZE) + ZERO_CHAR; k = k >> LOG_NODES_ALPHABET_SIZE; //d
+        temp[i] = NODE_CODE_LABEL[k & NODES_ALPHABET_SIZE]; k = k >> LOG_NODES_ALPHABET_SIZE; //d
     }
-    temp[0] = (k & NODES_ALPHABET_SIZE) + ZERO_CHAR; //root
+    temp[0] = NODE_CODE_LABEL[k & NODES_ALPHABET_SIZE]; //root
     
     ostringstream s;
     s << temp ;
@@ -210,9 +261,9 @@ string print_nkey(Element k)  {
 string print_ekey(Element k)  {    
 	string temp(HYPEREDGES_MAX_SIZE,ZERO_CHAR); 
     for (unsigned i=HYPEREDGES_MAX_SIZE-1; i > 0; i--)  {
-	    temp[i] = (k & HYPEREDGES_ALPHABET_SIZE) + ZERO_CHAR; k = k >> LOG_HYPEREDGES_ALPHABET_SIZE;
+	    temp[i] = EDGE_CODE_LABEL[k & HYPEREDGES_ALPHABET_SIZE]; k = k >> LOG_HYPEREDGES_ALPHABET_SIZE;
     }
-    temp[0] = (k & HYPEREDGES_ALPHABET_SIZE) + ZERO_CHAR; //e1
+    temp[0] = EDGE_CODE_LABEL[k & HYPEREDGES_ALPHABET_SIZE]; //e1
 
 	ostringstream s;
     s << temp ;
@@ -226,50 +277,50 @@ void make_key(Key &k, const Element nk, const Element ek)  {
 
 Element make_nodes_key(char root, char a, char b, char c, unsigned long hg_type)  {
     Element curr_nkey(0);
-	curr_nkey = ((unsigned long) (root-ZERO_CHAR)) << LOG_NODES_ALPHABET_SIZE;
-    curr_nkey = (curr_nkey+a-ZERO_CHAR) << LOG_NODES_ALPHABET_SIZE;	
-    curr_nkey = (curr_nkey+b-ZERO_CHAR) << LOG_NODES_ALPHABET_SIZE;
-    curr_nkey = (curr_nkey+c-ZERO_CHAR);
+	curr_nkey = ((unsigned long) NODE_LABEL_CODE[(unsigned char) root]) << LOG_NODES_ALPHABET_SIZE;
+    curr_nkey = (curr_nkey+NODE_LABEL_CODE[(unsigned char) a]) << LOG_NODES_ALPHABET_SIZE;	
+    curr_nkey = (curr_nkey+NODE_LABEL_CODE[(unsigned char) b]) << LOG_NODES_ALPHABET_SIZE;
+    curr_nkey = (curr_nkey+NODE_LABEL_CODE[(unsigned char) c]);
 	
     return curr_nkey;
 }
 
 Element make_hyperedges_key(char e1, char e2, char e3, char e4, char e5, char e6, char e7, char e8, char e9, char e10, char e11, unsigned long hg_type)  {
     Element curr_ekey(0);
-	curr_ekey = ((unsigned long) (e1-ZERO_CHAR)) << LOG_HYPEREDGES_ALPHABET_SIZE;
-    curr_ekey = (curr_ekey+e2-ZERO_CHAR) << LOG_HYPEREDGES_ALPHABET_SIZE;
-    curr_ekey = (curr_ekey+e3-ZERO_CHAR) << LOG_HYPEREDGES_ALPHABET_SIZE;
-    curr_ekey = (curr_ekey+e4-ZERO_CHAR) << LOG_HYPEREDGES_ALPHABET_SIZE;
-    curr_ekey = (curr_ekey+e5-ZERO_CHAR) << LOG_HYPEREDGES_ALPHABET_SIZE;
-    curr_ekey = (curr_ekey+e6-ZERO_CHAR) << LOG_HYPEREDGES_ALPHABET_SIZE;
-    curr_ekey = (curr_ekey+e7-ZERO_CHAR) << LOG_HYPEREDGES_ALPHABET_SIZE;
-    curr_ekey = (curr_ekey+e8-ZERO_CHAR) << LOG_HYPEREDGES_ALPHABET_SIZE;
-    curr_ekey = (curr_ekey+e9-ZERO_CHAR) << LOG_HYPEREDGES_ALPHABET_SIZE;
-    curr_ekey = (curr_ekey+e10-ZERO_CHAR) << LOG_HYPEREDGES_ALPHABET_SIZE;
-    curr_ekey = (curr_ekey+e11-ZERO_CHAR);
+	curr_ekey = ((unsigned long) EDGE_LABEL_CODE[(unsigned char) e1]) << LOG_HYPEREDGES_ALPHABET_SIZE;
+    curr_ekey = (curr_ekey+EDGE_LABEL_CODE[(unsigned char) e2]) << LOG_HYPEREDGES_ALPHABET_SIZE;
+    curr_ekey = (curr_ekey+EDGE_LABEL_CODE[(unsigned char) e3]) << LOG_HYPEREDGES_ALPHABET_SIZE;
+    curr_ekey = (curr_ekey+EDGE_LABEL_CODE[(unsigned char) e4]) << LOG_HYPEREDGES_ALPHABET_SIZE;
+    curr_ekey = (curr_ekey+EDGE_LABEL_CODE[(unsigned char) e5]) << LOG_HYPEREDGES_ALPHABET_SIZE;
+    curr_ekey = (curr_ekey+EDGE_LABEL_CODE[(unsigned char) e6]) << LOG_HYPEREDGES_ALPHABET_SIZE;
+    curr_ekey = (curr_ekey+EDGE_LABEL_CODE[(unsigned char) e7]) << LOG_HYPEREDGES_ALPHABET_SIZE;
+    curr_ekey = (curr_ekey+EDGE_LABEL_CODE[(unsigned char) e8]) << LOG_HYPEREDGES_ALPHABET_SIZE;
+    curr_ekey = (curr_ekey+EDGE_LABEL_CODE[(unsigned char) e9]) << LOG_HYPEREDGES_ALPHABET_SIZE;
+    curr_ekey = (curr_ekey+EDGE_LABEL_CODE[(unsigned char) e10]) << LOG_HYPEREDGES_ALPHABET_SIZE;
+    curr_ekey = (curr_ekey+EDGE_LABEL_CODE[(unsigned char) e11]);
 	
     return curr_ekey;
 }
 
 void initialize_vertices_labels(Element nkey, char &root, char &a, char &b, char &c)  {
-    c = (nkey & NODES_ALPHABET_SIZE) + ZERO_CHAR;  nkey = nkey >> LOG_NODES_ALPHABET_SIZE;
-    b = (nkey & NODES_ALPHABET_SIZE) + ZERO_CHAR;  nkey = nkey >> LOG_NODES_ALPHABET_SIZE;
-    a = (nkey & NODES_ALPHABET_SIZE) + ZERO_CHAR;  nkey = nkey >> LOG_NODES_ALPHABET_SIZE;
-    root = (nkey & NODES_ALPHABET_SIZE) + ZERO_CHAR;
+    c = NODE_CODE_LABEL[nkey & NODES_ALPHABET_SIZE];  nkey = nkey >> LOG_NODES_ALPHABET_SIZE;
+    b = NODE_CODE_LABEL[nkey & NODES_ALPHABET_SIZE];  nkey = nkey >> LOG_NODES_ALPHABET_SIZE;
+    a = NODE_CODE_LABEL[nkey & NODES_ALPHABET_SIZE];  nkey = nkey >> LOG_NODES_ALPHABET_SIZE;
+    root = NODE_CODE_LABEL[nkey & NODES_ALPHABET_SIZE];
 }
 
 void initialize_edges_labels(Element ekey, char &e1, char &e2, char &e3, char &e4, char &e5, char &e6, char &e7, char &e8, char &e9, char &e10, char &e11)  {
-    e11 = (ekey & HYPEREDGES_ALPHABET_SIZE) + ZERO_CHAR;  ekey = ekey >> LOG_HYPEREDGES_ALPHABET_SIZE;
-    e10 = (ekey & HYPEREDGES_ALPHABET_SIZE) + ZERO_CHAR;  ekey = ekey >> LOG_HYPEREDGES_ALPHABET_SIZE;
-    e9 = (ekey & HYPEREDGES_ALPHABET_SIZE) + ZERO_CHAR;  ekey = ekey >> LOG_HYPEREDGES_ALPHABET_SIZE;
-    e8 = (ekey & HYPEREDGES_ALPHABET_SIZE) + ZERO_CHAR;  ekey = ekey >> LOG_HYPEREDGES_ALPHABET_SIZE;
-    e7 = (ekey & HYPEREDGES_ALPHABET_SIZE) + ZERO_CHAR;  ekey = ekey >> LOG_HYPEREDGES_ALPHABET_SIZE;
-    e6 = (ekey & HYPEREDGES_ALPHABET_SIZE) + ZERO_CHAR;  ekey = ekey >> LOG_HYPEREDGES_ALPHABET_SIZE;
-    e5 = (ekey & HYPEREDGES_ALPHABET_SIZE) + ZERO_CHAR;  ekey = ekey >> LOG_HYPEREDGES_ALPHABET_SIZE;
-    e4 = (ekey & HYPEREDGES_ALPHABET_SIZE) + ZERO_CHAR;  ekey = ekey >> LOG_HYPEREDGES_ALPHABET_SIZE;
-    e3 = (ekey & HYPEREDGES_ALPHABET_SIZE) + ZERO_CHAR;  ekey = ekey >> LOG_HYPEREDGES_ALPHABET_SIZE;
-    e2 = (ekey & HYPEREDGES_ALPHABET_SIZE) + ZERO_CHAR;  ekey = ekey >> LOG_HYPEREDGES_ALPHABET_SIZE;
-    e1 = (ekey & HYPEREDGES_ALPHABET_SIZE) + ZERO_CHAR;
+    e11 = EDGE_CODE_LABEL[ekey & HYPEREDGES_ALPHABET_SIZE];  ekey = ekey >> LOG_HYPEREDGES_ALPHABET_SIZE;
+    e10 = EDGE_CODE_LABEL[ekey & HYPEREDGES_ALPHABET_SIZE];  ekey = ekey >> LOG_HYPEREDGES_ALPHABET_SIZE;
+    e9 = EDGE_CODE_LABEL[ekey & HYPEREDGES_ALPHABET_SIZE];  ekey = ekey >> LOG_HYPEREDGES_ALPHABET_SIZE;
+    e8 = EDGE_CODE_LABEL[ekey & HYPEREDGES_ALPHABET_SIZE];  ekey = ekey >> LOG_HYPEREDGES_ALPHABET_SIZE;
+    e7 = EDGE_CODE_LABEL[ekey & HYPEREDGES_ALPHABET_SIZE];  ekey = ekey >> LOG_HYPEREDGES_ALPHABET_SIZE;
+    e6 = EDGE_CODE_LABEL[ekey & HYPEREDGES_ALPHABET_SIZE];  ekey = ekey >> LOG_HYPEREDGES_ALPHABET_SIZE;
+    e5 = EDGE_CODE_LABEL[ekey & HYPEREDGES_ALPHABET_SIZE];  ekey = ekey >> LOG_HYPEREDGES_ALPHABET_SIZE;
+    e4 = EDGE_CODE_LABEL[ekey & HYPEREDGES_ALPHABET_SIZE];  ekey = ekey >> LOG_HYPEREDGES_ALPHABET_SIZE;
+    e3 = EDGE_CODE_LABEL[ekey & HYPEREDGES_ALPHABET_SIZE];  ekey = ekey >> LOG_HYPEREDGES_ALPHABET_SIZE;
+    e2 = EDGE_CODE_LABEL[ekey & HYPEREDGES_ALPHABET_SIZE];  ekey = ekey >> LOG_HYPEREDGES_ALPHABET_SIZE;
+    e1 = EDGE_CODE_LABEL[ekey & HYPEREDGES_ALPHABET_SIZE];
 }
 
 Element get_feature_id_nodes(Element nkey, unsigned long hg_type)  {
@@ -42849,3 +42900,66 @@ void update_edge_mismatch_count(vector<list<pair <unsigned long, Key> > > &EM_se
             break;
     }
 }
+
+// Generate all labeled hypergraphlets that are exactly one edit operation (vertex label substitution, hyperedge label substitution
+// or hyperedge insertion/deletion) away from the input hypergraphlet.
+void generate_edit_operations_neighborhood(vector<EditOperation> &neighborhood, Key key, unsigned long hg_type, string ALPHABET_ROOT, string ALPHABET, string EDGES_ALPHABET, map<string, float> &sim_vlm_matrix, map<string, float> &sim_elm_matrix)  {
+    list<Key> vl_neighborhood, el_neighborhood;
+    list<pair <unsigned long, Key> > L;
+    vector<list<pair <unsigned long, Key> > > EM_set(1, L);
+    EditOperation op;
+
+    neighborhood.clear();
+
+    // Vertex label substitutions
+    generate_hypergraphlet_mismatch_neighborhood_m1(vl_neighborhood, ALPHABET_ROOT, ALPHABET, sim_vlm_matrix, hg_type, key.first, key.second);
+    for (list<Key>::iterator list_it = vl_neighborhood.begin(); list_it != vl_neighborhood.end(); list_it++)  {
+        if (*list_it == key)
+            continue;
+        op.operation = VERTEX_LABEL_SUBSTITUTION;
+        op.hg_type = hg_type;
+        op.key = *list_it;
+        neighborhood.push_back(op);
+    }
+
+    // Hyperedge label substitutions
+    generate_hypergraphlet_mismatch_neighborhood_for_edges_m1(el_neighborhood, EDGES_ALPHABET, sim_elm_matrix, hg_type, key.first, key.second);
+    for (list<Key>::iterator list_it = el_neighborhood.begin(); list_it != el_neighborhood.end(); list_it++)  {
+        if (*list_it == key)
+            continue;
+        op.operation = HYPEREDGE_LABEL_SUBSTITUTION;
+        op.hg_type = hg_type;
+        op.key = *list_it;
+        neighborhood.push_back(op);
+    }
+
+    // Hyperedge insertions and deletions
+    update_edge_mismatch_count(EM_set, key, hg_type, 1, 0, EDGES_ALPHABET);
+    for (list<pair <unsigned long, Key> >::iterator list_it = EM_set[0].begin(); list_it != EM_set[0].end(); list_it++)  {
+        if (list_it->first == hg_type && list_it->second == key)
+            continue;
+        op.operation = HYPEREDGE_INDEL;
+        op.hg_type = list_it->first;
+        op.key = list_it->second;
+        neighborhood.push_back(op);
+    }
+}
+
+// Dot product between two sparse feature vectors (merge join over their sorted feature ids).
+float features_dot_product(const map<Key,float> &g_features, const map<Key,float> &h_features)  {
+    float sum(0.0);
+    map<Key,float>::const_iterator git = g_features.begin(), hit = h_features.begin();
+
+    while (git != g_features.end() && hit != h_features.end())  {
+        if (git->first < hit->first)
+            git++;
+        else if (hit->first < git->first)
+            hit++;
+        else  {
+            sum += git->second * hit->second;
+            git++;
+            hit++;
+        }
+    }
+    return sum;
+}
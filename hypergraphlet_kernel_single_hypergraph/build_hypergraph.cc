@@ -0,0 +1,462 @@
+/**
+ * Builds a vertex- and edge-labeled hypergraph (.hypergraph, .nlabels and
+ * .elabels files) from tab-separated interaction pairs with string
+ * identifiers, such as the data/ppis and data/dtis files.
+ *
+ * Each distinct pair becomes a 2-hyperedge, and each line of an optional
+ * complexes file becomes a hyperedge over all of its members.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include "string.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#include <parallel/algorithm>
+#endif
+using namespace std;
+
+
+typedef pair<unsigned, unsigned> Pair;
+
+
+void print_help()  {
+    cout << "Usage: build_hypergraph -i FILE -o PREFIX [...]\n";
+    cout << "Options:\n\n";
+
+    cout << "  -h         Displays this message.\n\n";
+
+    cout << "  -i FILE    Interaction pairs, one per line as two tab- or space-separated identifiers (e.g. hsa:10 D00002).\n";
+    cout << "             Several files are given by repeating -i. Reversed and repeated pairs are kept once, and self-interactions are dropped.\n\n";
+
+    cout << "  -H LINES   Number of header lines skipped at the start of each pairs file (e.g. 1 for STRING files). Defaults to 0.\n\n";
+
+    cout << "  -s SCORE   Keeps only the pairs whose third column (e.g. the STRING combined_score) is at least SCORE.\n";
+    cout << "             Without -s, any columns after the two identifiers are ignored.\n\n";
+
+    cout << "  -c FILE    Complexes, one per line as tab- or space-separated identifiers. Each complex becomes a single hyperedge.\n\n";
+
+    cout << "  -a         Absorbs the pairs whose identifiers share a complex into the complex hyperedges.\n\n";
+
+    cout << "  -l FILE    Vertex labels, one identifier and its single-character label per line.\n\n";
+
+    cout << "  -d LABEL   Label of vertices without one in the -l file. Defaults to A.\n\n";
+
+    cout << "  -e LABEL   Label of pair hyperedges. Defaults to E.\n\n";
+
+    cout << "  -f LABEL   Label of complex hyperedges. Defaults to F.\n\n";
+
+    cout << "  -o PREFIX  Output prefix of the PREFIX.hypergraph, PREFIX.nlabels and PREFIX.elabels files, and of PREFIX.ids,\n";
+    cout << "             which lists the identifier of each vertex id (line number, starting at 0).\n\n";
+
+    cout << "  -T THREADS Number of threads used to parse the pairs and write the hypergraph. Defaults to 1.\n\n";
+
+    cout << "  -v         Verbose mode.\n\n";
+}
+
+// Identifiers in the order in which they were first seen, and the vertex id of each.
+struct IdTable  {
+    vector<string> names;
+    unordered_map<string, unsigned> ids;
+
+    unsigned intern(const string &name)  {
+        unordered_map<string, unsigned>::iterator it = ids.find(name);
+        if (it != ids.end())
+            return it->second;
+        ids[name] = names.size();
+        names.push_back(name);
+        return names.size() - 1;
+    }
+};
+
+// Pairs of one newline-aligned chunk of a pairs file, over identifiers local to the chunk.
+struct ParsedChunk  {
+    IdTable table;
+    vector<Pair> pairs;
+    unsigned long skipped, filtered;  // Self-interactions, and pairs below the score threshold.
+
+    ParsedChunk() : skipped(0), filtered(0) {}
+};
+
+// Pairs file layout options.
+struct PairsFormat  {
+    unsigned header_lines;
+    bool use_score;
+    double min_score;
+
+    PairsFormat() : header_lines(0), use_score(false), min_score(0.0) {}
+};
+
+inline bool is_separator(char c)  {
+    return c == '\t' || c == ' ' || c == '\r';
+}
+
+// Parses the lines between begin and end; comments (#) and blank lines are skipped.
+void parse_pairs_chunk(const char *begin, const char *end, const PairsFormat &format, ParsedChunk &chunk)  {
+    const char *p = begin;
+    while (p < end)  {
+        const char *line_end = (const char*) memchr(p, '\n', end - p);
+        if (line_end == NULL)
+            line_end = end;
+
+        const char *fields[3];
+        size_t lengths[3];
+        unsigned found(0), wanted(format.use_score ? 3 : 2);
+        const char *q = p;
+        while (found < wanted)  {
+            while (q < line_end && is_separator(*q))
+                q++;
+            if (q == line_end)
+                break;
+            fields[found] = q;
+            while (q < line_end && !is_separator(*q))
+                q++;
+            lengths[found] = q - fields[found];
+            found++;
+        }
+
+        if (found > 0 && fields[0][0] != '#')  {
+            if (found < wanted)  {
+                cerr << "ERROR: Invalid pair " << string(p, line_end - p) << endl;  exit(1);
+            }
+            if (format.use_score)  {
+                string score(fields[2], lengths[2]);
+                char *score_end;
+                double value = strtod(score.c_str(), &score_end);
+                if (*score_end != '\0')  {
+                    cerr << "ERROR: Invalid score in pair " << string(p, line_end - p) << endl;  exit(1);
+                }
+                if (value < format.min_score)  {
+                    chunk.filtered++;
+                    p = line_end + 1;
+                    continue;
+                }
+            }
+            unsigned u = chunk.table.intern(string(fields[0], lengths[0]));
+            unsigned v = chunk.table.intern(string(fields[1], lengths[1]));
+            if (u == v)
+                chunk.skipped++;
+            else
+                chunk.pairs.push_back(make_pair(u, v));
+        }
+        p = line_end + 1;
+    }
+}
+
+// Reads the pairs of one file with one chunk per thread, and adds them over the global identifiers.
+unsigned long read_pairs(const string &file, const PairsFormat &format, unsigned threads, IdTable &table, vector<Pair> &pairs, unsigned long &filtered)  {
+    int fd = open(file.c_str(), O_RDONLY);
+    if (fd < 0)  {
+        cerr << "ERROR: Pairs file " << file << " cannot be opened." << endl;  exit(1);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0)  {
+        cerr << "ERROR: Pairs file " << file << " cannot be read." << endl;  exit(1);
+    }
+    size_t size = st.st_size;
+    if (size == 0)  {
+        close(fd);
+        return 0;
+    }
+    const char *data = (const char*) mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED)  {
+        cerr << "ERROR: Pairs file " << file << " cannot be mapped." << endl;  exit(1);
+    }
+
+    // Header lines are skipped before the file is split.
+    const char *start = data;
+    for (unsigned l=0; l<format.header_lines && start < data + size; l++)  {
+        const char *newline = (const char*) memchr(start, '\n', data + size - start);
+        start = newline == NULL ? data + size : newline + 1;
+    }
+
+    // Chunk boundaries are moved forward to the next line start.
+    vector<const char*> bounds(threads + 1);
+    bounds[0] = start;
+    bounds[threads] = data + size;
+    for (unsigned t=1; t<threads; t++)  {
+        const char *b = start + (data + size - start) / threads * t;
+        b = max(b, bounds[t-1]);
+        const char *newline = (const char*) memchr(b, '\n', data + size - b);
+        bounds[t] = newline == NULL ? data + size : newline + 1;
+    }
+
+    vector<ParsedChunk> chunks(threads);
+    #pragma omp parallel for schedule(static, 1) num_threads(threads)
+    for (unsigned t=0; t<threads; t++)
+        parse_pairs_chunk(bounds[t], bounds[t+1], format, chunks[t]);
+    munmap((void*) data, size);
+    close(fd);
+
+    // Merging the chunks in file order numbers the identifiers as a single sequential pass would.
+    unsigned long skipped(0);
+    vector<vector<unsigned> > global_ids(threads);
+    for (unsigned t=0; t<threads; t++)  {
+        global_ids[t].resize(chunks[t].table.names.size());
+        for (unsigned i=0; i<chunks[t].table.names.size(); i++)
+            global_ids[t][i] = table.intern(chunks[t].table.names[i]);
+        chunks[t].table = IdTable();
+        skipped += chunks[t].skipped;
+        filtered += chunks[t].filtered;
+    }
+
+    vector<size_t> offsets(threads + 1, pairs.size());
+    for (unsigned t=0; t<threads; t++)
+        offsets[t+1] = offsets[t] + chunks[t].pairs.size();
+    pairs.resize(offsets[threads]);
+    #pragma omp parallel for schedule(static, 1) num_threads(threads)
+    for (unsigned t=0; t<threads; t++)  {
+        for (size_t i=0; i<chunks[t].pairs.size(); i++)  {
+            unsigned u = global_ids[t][chunks[t].pairs[i].first];
+            unsigned v = global_ids[t][chunks[t].pairs[i].second];
+            pairs[offsets[t] + i] = make_pair(min(u, v), max(u, v));
+        }
+        vector<Pair>().swap(chunks[t].pairs);
+    }
+
+    return skipped;
+}
+
+// Reads one complex per line; members are kept once, in increasing vertex id.
+void read_complexes(const string &file, IdTable &table, vector<vector<unsigned> > &complexes)  {
+    ifstream in(file.c_str(), ios::in);
+    if (in.fail())  {
+        cerr << "ERROR: Complexes file " << file << " cannot be opened." << endl;  exit(1);
+    }
+    string line;
+    while (getline(in, line))  {
+        line = strip(line);
+        if (line.size() == 0 || line[0] == '#')
+            continue;
+        for (unsigned i=0; i<line.size(); i++)  {
+            if (line[i] == ' ')
+                line[i] = '\t';
+        }
+
+        vector<unsigned> members;
+        vector<string> tokens = split(line, '\t');
+        for (unsigned i=0; i<tokens.size(); i++)  {
+            if (tokens[i].size() > 0)
+                members.push_back(table.intern(tokens[i]));
+        }
+        sort(members.begin(), members.end());
+        members.erase(unique(members.begin(), members.end()), members.end());
+        if (members.size() > 1)
+            complexes.push_back(members);
+    }
+    in.close();
+}
+
+// Removes the pairs whose two vertices belong to a common complex.
+unsigned long absorb_pairs(vector<Pair> &pairs, const vector<vector<unsigned> > &complexes, unsigned num_vertices, unsigned threads)  {
+    vector<vector<unsigned> > vertex_complexes(num_vertices);
+    for (unsigned c=0; c<complexes.size(); c++)  {
+        for (unsigned i=0; i<complexes[c].size(); i++)
+            vertex_complexes[complexes[c][i]].push_back(c);
+    }
+
+    vector<char> covered(pairs.size(), 0);
+    #pragma omp parallel for schedule(static) num_threads(threads)
+    for (size_t i=0; i<pairs.size(); i++)  {
+        const vector<unsigned> &a = vertex_complexes[pairs[i].first];
+        const vector<unsigned> &b = vertex_complexes[pairs[i].second];
+        unsigned x(0), y(0);
+        while (x < a.size() && y < b.size() && !covered[i])  {
+            if (a[x] == b[y])
+                covered[i] = 1;
+            else if (a[x] < b[y])
+                x++;
+            else
+                y++;
+        }
+    }
+
+    size_t kept(0);
+    for (size_t i=0; i<pairs.size(); i++)  {
+        if (!covered[i])
+            pairs[kept++] = pairs[i];
+    }
+    unsigned long absorbed = pairs.size() - kept;
+    pairs.resize(kept);
+    return absorbed;
+}
+
+// Reads one identifier and its label per line; identifiers that are not vertices are counted and ignored.
+unsigned long read_vertex_labels(const string &file, IdTable &table, string &node_labels)  {
+    ifstream in(file.c_str(), ios::in);
+    if (in.fail())  {
+        cerr << "ERROR: Vertex labels file " << file << " cannot be opened." << endl;  exit(1);
+    }
+    unsigned long unknown(0);
+    string line;
+    while (getline(in, line))  {
+        line = strip(line);
+        if (line.size() == 0 || line[0] == '#')
+            continue;
+        size_t sep = line.find_first_of("\t ");
+        string label = sep == string::npos ? string() : strip(line.substr(sep));
+        if (label.size() != 1)  {
+            cerr << "ERROR: Invalid vertex label line " << line << " in file " << file << endl;  exit(1);
+        }
+        unordered_map<string, unsigned>::iterator it = table.ids.find(line.substr(0, sep));
+        if (it == table.ids.end())
+            unknown++;
+        else
+            node_labels[it->second] = label[0];
+    }
+    in.close();
+    return unknown;
+}
+
+inline void append_unsigned(string &s, unsigned long value)  {
+    char digits[24];
+    unsigned n(0);
+    do  {
+        digits[n++] = '0' + value % 10;
+        value /= 10;
+    } while (value > 0);
+    while (n > 0)
+        s += digits[--n];
+}
+
+// Formats the hyperedges in blocks, one per thread, and writes the blocks in order.
+void write_hypergraph(const string &file, const vector<Pair> &pairs, const vector<vector<unsigned> > &complexes, unsigned threads)  {
+    ofstream out(file.c_str(), ios::out | ios::binary);
+    if (out.fail())  {
+        cerr << "ERROR: Hypergraph file " << file << " cannot be written." << endl;  exit(1);
+    }
+
+    size_t num_edges = pairs.size() + complexes.size();
+    size_t block_size = 1 << 20;
+    for (size_t start=0; start<num_edges; start+=block_size*threads)  {
+        vector<string> blocks(threads);
+        #pragma omp parallel for schedule(static, 1) num_threads(threads)
+        for (unsigned t=0; t<threads; t++)  {
+            size_t from = min(num_edges, start + t*block_size), to = min(num_edges, from + block_size);
+            for (size_t e=from; e<to; e++)  {
+                append_unsigned(blocks[t], e);
+                if (e < pairs.size())  {
+                    blocks[t] += '\t';  append_unsigned(blocks[t], pairs[e].first);
+                    blocks[t] += '\t';  append_unsigned(blocks[t], pairs[e].second);
+                }
+                else  {
+                    const vector<unsigned> &members = complexes[e - pairs.size()];
+                    for (unsigned i=0; i<members.size(); i++)  {
+                        blocks[t] += '\t';  append_unsigned(blocks[t], members[i]);
+                    }
+                }
+                blocks[t] += '\n';
+            }
+        }
+        for (unsigned t=0; t<threads; t++)
+            out.write(blocks[t].data(), blocks[t].size());
+    }
+    out.close();
+}
+
+int main(int argc, char* argv[])  {
+    vector<string> pairs_files;
+    string complexes_file, labels_file, prefix;
+    char vertex_label('A'), pair_label('E'), complex_label('F');
+    bool absorb(false), verbose(false);
+    unsigned threads(1);
+    PairsFormat format;
+
+    // Parse command line arguments.
+    for (int i=1; i<argc && (argv[i])[0] == '-'; i++)  {
+        switch ((argv[i])[1])  {
+            case 'h': print_help(); exit(0);
+            case 'i': i++; pairs_files.push_back(argv[i]); break;
+            case 'H': i++; format.header_lines=max(0, to_i(argv[i])); break;
+            case 's': i++; format.use_score=true; format.min_score=to_f(argv[i]); break;
+            case 'c': i++; complexes_file=argv[i]; break;
+            case 'a': absorb=true; break;
+            case 'l': i++; labels_file=argv[i]; break;
+            case 'd': i++; vertex_label=argv[i][0]; break;
+            case 'e': i++; pair_label=argv[i][0]; break;
+            case 'f': i++; complex_label=argv[i][0]; break;
+            case 'o': i++; prefix=argv[i]; break;
+            case 'T': i++; threads=max(1, to_i(argv[i])); break;
+            case 'v': verbose=true; break;
+            default:
+                cerr << "ERROR: Unknown option " << argv[i] << endl;
+                print_help();  exit(1);
+        }
+    }
+
+    if (pairs_files.size() == 0 && complexes_file.size() == 0)  {
+        cerr << "ERROR: Neither pairs nor complexes files specified." << endl;  print_help();  exit(1);
+    }
+    if (prefix.size() == 0)  {
+        cerr << "ERROR: Output prefix not specified." << endl;  print_help();  exit(1);
+    }
+
+    IdTable table;
+    vector<Pair> pairs;
+    for (unsigned f=0; f<pairs_files.size(); f++)  {
+        if (verbose)  cerr << "Reading pairs file " << pairs_files[f] << " ... ";
+        unsigned long below_threshold(0);
+        unsigned long self_pairs = read_pairs(pairs_files[f], format, threads, table, pairs, below_threshold);
+        if (verbose)  {
+            cerr << pairs.size() << " pairs, " << self_pairs << " self-interactions dropped";
+            if (format.use_score)
+                cerr << ", " << below_threshold << " below score " << format.min_score;
+            cerr << endl;
+        }
+    }
+
+#ifdef _OPENMP
+    __gnu_parallel::sort(pairs.begin(), pairs.end());
+#else
+    sort(pairs.begin(), pairs.end());
+#endif
+    pairs.erase(unique(pairs.begin(), pairs.end()), pairs.end());
+
+    vector<vector<unsigned> > complexes;
+    if (complexes_file.size() > 0)  {
+        if (verbose)  cerr << "Reading complexes file " << complexes_file << " ... ";
+        read_complexes(complexes_file, table, complexes);
+        if (verbose)  cerr << complexes.size() << " complexes" << endl;
+        if (absorb)  {
+            unsigned long absorbed = absorb_pairs(pairs, complexes, table.names.size(), threads);
+            if (verbose)  cerr << absorbed << " pairs absorbed into complexes" << endl;
+        }
+    }
+
+    string node_labels(table.names.size(), vertex_label);
+    if (labels_file.size() > 0)  {
+        unsigned long unknown = read_vertex_labels(labels_file, table, node_labels);
+        if (verbose)  cerr << "Vertex labels read, " << unknown << " identifiers not in the hypergraph" << endl;
+    }
+    string edge_labels = string(pairs.size(), pair_label) + string(complexes.size(), complex_label);
+
+    if (verbose)  cerr << "Writing hypergraph with " << node_labels.size() << " vertices and " << edge_labels.size() << " hyperedges ... " << endl;
+    write_hypergraph(prefix + ".hypergraph", pairs, complexes, threads);
+
+    ofstream nout((prefix + ".nlabels").c_str(), ios::out);
+    nout << node_labels << endl;
+    nout.close();
+
+    ofstream eout((prefix + ".elabels").c_str(), ios::out);
+    eout << edge_labels << endl;
+    eout.close();
+
+    ofstream iout((prefix + ".ids").c_str(), ios::out);
+    for (unsigned i=0; i<table.names.size(); i++)
+        iout << table.names[i] << "\n";
+    iout.close();
+
+    exit(0);
+}
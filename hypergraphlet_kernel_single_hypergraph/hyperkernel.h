@@ -22,13 +22,15 @@
 #include <map>
 #include <vector>
 #include <set>
+#include <stdint.h>
 #include <sys/time.h>
+#include <ctime>
 using namespace std;
 
 
 class HyperKernels  {
 public:
-    HyperKernels() : NORMALIZE(false), VERBOSE(false), SF(0.0), ELM(0), EM(0) {}
+    HyperKernels() : NORMALIZE(false), VERBOSE(false), KEEP_COUNTS(false), FUSED(false), SF(0.0), ELM(0), EM(0), ED(0), train_size(0), THREADS(1), SAMPLES(0), VERTEX_ORDER(INPUT_ORDER), CHECKPOINT_INTERVAL(600), RESUME(false), last_checkpoint(0), single_label(false), hub_cost(-1.0), counting_hubs(false) {}
     ~HyperKernels()  {}
      
     /** Read a vertex- and hyperedge-labeled hypergraph and a list of vertex of interest. */
@@ -37,6 +39,18 @@ public:
     /** Read a vertex- and hyperedge-labeled dual hypergraph and a list of vertex of interest. */
     void read_dual_hypergraph(string, string, string, const vector<unsigned> &);
 
+    /** Adds and removes the hyperedges listed in a delta file, and returns the vertices whose hypergraphlet counts may have changed. */
+    set<unsigned> update_hypergraph(string delta_file);
+
+    /** Writes the current hypergraph back to vertex labels, hyperedge labels and hypergraph files, e.g. after an update. */
+    void write_hypergraph(string, string, string);
+
+    /** Replaces the list of vertices of interest of the current hypergraph. Kept exact counts of vertices shared with the previous list are reused. */
+    void set_roots(const vector<unsigned> &);
+
+    /** Appends query vertices that are compared only against the current vertices of interest, so kernels hold the training block plus query rows. */
+    void add_query_roots(const vector<unsigned> &);
+
     /** Read a probability similarity matrix for each vertex label so that we can weight each vertex label substitution. */
     void read_sim_vlm_matrix(string filename);
 
@@ -55,6 +69,12 @@ public:
     /** Compute label substitutions hyperkernel matrix. */
     void compute_label_mismatch_matrix();
 
+    /** Compute label substitutions hyperkernel matrix root by root: one feature vector per root over all types, then a single Gram pass. */
+    void compute_fused_label_mismatch_matrix();
+
+    /** Compute standard hyperkernel matrix of a single-labeled hypergraph as dot products of dense type counts. */
+    void compute_type_counts_matrix();
+
     /** Compute hyperedge indels hyperkernel matrix. */
     void compute_edge_mismatch_matrix();
 
@@ -64,9 +84,33 @@ public:
     /** Compute edit distance (with 2 operations) hyperkernel matrix. */
     void compute_edit_distance2_matrix();
 
+    /** Compute edit distance (with up to ED combined operations) hyperkernel matrix. */
+    void compute_generalized_edit_distance_matrix();
+
+    /** Grows the kernel matrix over the vertices stored in a features file to the new vertices of interest, computing only their rows (and those of updated vertices) as feature dot products. */
+    void compute_incremental_matrix(const char *kernel_file, const char *features_file, const set<unsigned> &updated_vertices = set<unsigned>());
+
+    /** Appends rows of query vertices to a matrix grown by compute_incremental_matrix, as dot products with the training feature vectors. */
+    void compute_query_rows(const vector<unsigned> &query_vertices);
+
     /** Writes distance kernel matrix in either: 1:triangular binary form, 2:triangular standard output form, 3: squared-matrix standard output form. */
     void write_matrix(const char*);
 
+    /** Writes the training triangle and the query rows of the kernel matrix in binary form (OUTPUT_FORMAT 0). */
+    void write_binary_matrix(const char*);
+
+    /** Writes the lower triangle of the kernel matrix to standard output form (OUTPUT_FORMAT 1). */
+    void write_triangular_matrix(const char*);
+
+    /** Writes the squared kernel matrix to standard output form, with query rows over the training columns (OUTPUT_FORMAT 2). */
+    void write_square_matrix(const char*);
+
+    /** Writes the kernel matrix of vertex pairs, given as indices into the vertices of interest, from the computed vertex kernel matrix. */
+    void write_pair_matrix(const char*, const vector<pair<unsigned,unsigned> > &pairs);
+
+    /** Writes the attributes of vertex pairs, given as indices into the vertices of interest, as the elementwise sum and product of the feature vectors of both vertices, or as their symmetric tensor product. */
+    void write_pair_sparse_svml(const char*, const vector<pair<unsigned,unsigned> > &pairs, bool tensor);
+
     /**  */
     void write_sparse_svml_lm(const char*);
 
@@ -79,13 +123,50 @@ public:
     /** */
     void write_sparse_svml_ed2(const char*);
 
+    /** */
+    void write_sparse_svml_ged(const char*);
+
     /** */
     void write_labels(const char *);
 
-    inline void set_normalize()  { NORMALIZE = true; } 
+    /** Writes the feature vector of each vertex of interest (computed by compute_incremental_matrix), one vertex per line after a tag line. */
+    void write_features(const char *);
+
+    /** Returns the feature vector of any vertex for the current kernel parameters: edit distance features if ED > 0, (label substitutions) hypergraphlet features otherwise. */
+    map<Key,float> get_vertex_features(unsigned v);
+
+    /** Returns the feature vectors of several vertices, as get_vertex_features, counting their hypergraphlets in parallel. */
+    vector<map<Key,float> > get_vertices_features(const vector<unsigned> &vertices);
+
+    inline unsigned get_threads()  { return THREADS; }
+
+    inline unsigned get_number_vertices()  { return hypergraph.node_labels.size(); }
+
+    inline void set_normalize(bool normalize = true)  { NORMALIZE = normalize; } 
 
     inline void set_verbose()  { VERBOSE = true; }
 
+    /** Estimates the counts of roots with more first-level neighbors than the budget from that many sampled neighbors (0: exact counts). */
+    inline void set_sample_budget(unsigned samples)  { SAMPLES = samples; }
+
+    /** Labels besides those of the hypergraph read next that may appear in keys, such as the label substitution alphabets. */
+    inline void set_label_alphabets(string vertex_symbols, string edge_symbols)  { VERTEX_SYMBOLS = vertex_symbols; EDGE_SYMBOLS = edge_symbols; }
+
+    /** Renumbers the hypergraph read next for locality; vertices of interest and outputs keep the original ids. */
+    inline void set_vertex_order(VertexOrder order)  { VERTEX_ORDER = order; }
+
+    /** Counts hypergraphlets of several vertices of interest at once, and splits hub vertices across threads (needs OpenMP). */
+    inline void set_threads(unsigned threads)  { THREADS = threads > 0 ? threads : 1; }
+
+    /** Snapshots the kernel being computed to a file at most every interval seconds, and continues from a matching snapshot if resuming. */
+    inline void set_checkpoint(string file, unsigned interval, bool resume)  { CHECKPOINT = file; CHECKPOINT_INTERVAL = interval; RESUME = resume; }
+
+    /** Computes the label substitutions hyperkernel root-major instead of type-major (see compute_fused_label_mismatch_matrix). */
+    inline void set_fused_passes()  { FUSED = true; }
+
+    /** Keeps the exact hypergraphlet counts and mismatch neighborhoods of each vertex of interest so that several kernels can be computed from one enumeration. */
+    inline void set_keep_counts()  { KEEP_COUNTS = true; }
+
     inline void set_number_vertex_label_mismatches(float fraction)  { SF = fraction; }
     
     inline void set_vertex_label_mismatches_alphabet(string alphabet)  { ALPHABET = alphabet; }
@@ -97,6 +178,10 @@ public:
     inline void set_number_edge_label_mismatches(int elm)  { ELM = elm; }
 
 	inline void set_number_edges_mismatches(unsigned edges_mismatches)  { EM = edges_mismatches; }
+
+    inline void set_edit_distance(unsigned edit_distance)  { ED = edit_distance; }
+
+    inline void set_edit_distance_weights(const vector<float> &weights)  { ED_WEIGHTS = weights; }
    
 private:
 	/** Returns the cumulative random walk hyperkernel between two rooted neighborhoods. */
@@ -114,12 +199,92 @@ private:
 	/** Insert the counts of induced labeled 4-hypergraphlets. */
 	void insert_induced_hypergraphlets(vector<map<Key,MismatchInfo> > &hash, char root, char a, char b, char c, vector<char> e1, vector<char> e2, vector<char> e3, vector<char> e4, vector<char> e5, vector<char> e6, vector<char> e7, vector<char> e8, vector<char> e9, vector<char> e10, vector<char> e11, bool found_rijk, bool found_rij, bool found_rik, bool found_rjk, bool found_ijk, bool found_ri, bool found_rj, bool found_rk, bool found_ij, bool found_ik, bool found_jk);
 
+	/** Sets the codes packed into keys for the labels of the hypergraph and the label alphabets. */
+	void encode_labels();
+
+	/** Checks whether all vertices and all hyperedges of the hypergraph share one label, and resets the caches derived from the hypergraph. */
+	void detect_single_label();
+
+	/** Adds the weighted induced hypergraphlets formed by the root, its neighbor i and (sampled) vertices not visited before i; returns their total. */
+	double count_first_neighbor_hypergraphlets(SimpleHypergraph &hg, unsigned hg_root, unsigned i, float weight, vector<map<Key,MismatchInfo> > &hash, double *type_counts, bool &sampled);
+
+	/** Keeps a random sample of the vertices if they exceed the sample budget; returns whether it did. */
+	bool sample_vertices(unsigned seed, vector<unsigned> &vertices);
+
+	/** Moves the counts of hypergraphlets on the given number of vertices from level to hash, scaled by weight; returns their total. */
+	double add_weighted_counts(vector<map<Key,MismatchInfo> > &hash, vector<map<Key,MismatchInfo> > &level, unsigned vertices, float weight);
+
+	/** Reports the estimated number of hypergraphlets of a sampled root, and its confidence interval if its first-level neighbors were sampled. */
+	void report_sampled_counts(unsigned hg_root, unsigned degree, const vector<double> &neighbor_totals, bool sampled_extensions);
+
+	/** Adds the counts of one vector of hypergraphlet counts to another. */
+	void merge_hypergraphlets_counts(vector<map<Key,MismatchInfo> > &hash, const vector<map<Key,MismatchInfo> > &local_hash);
+
+	/** Returns the neighbors of each vertex of the hypergraph, sorted by original id, computing them on first use. */
+	const vector<vector<unsigned> > &get_vertex_neighbors();
+
+	/** Returns a degree-based estimate of the cost of enumerating the hypergraphlets rooted at vertex v. */
+	double estimate_root_cost(unsigned v);
+
+	/** Whether the enumeration from vertex v is split across threads (only outside other parallel work, and only for hubs). */
+	bool split_root(unsigned v);
+
+	/** Returns the estimated cost above which a vertex of interest counted on its own is a hub, computing it on first use. */
+	double get_hub_cost();
+
+	/** Adds the hypergraphlets formed by the root and 1 to 3 other vertices with the given hyperedge sets to dense type counts with a weight (single-labeled hypergraphs); returns the weighted number added. */
+	double count_single_label_hypergraphlets(double *type_counts, unsigned vertices, const unsigned *sizes, float weight);
+
+	/** Returns the type of a pattern of non-empty hyperedge sets and the powers of the set sizes in its count, found by inserting it with single labels. */
+	PatternType get_pattern_type(unsigned vertices, unsigned pattern, vector<map<Key,MismatchInfo> > &hash);
+
+	/** Inserts the hyperedge sets of the given sizes with single labels into an empty hash, left empty; returns the type counted (-1 if none) and its count. */
+	int insert_single_label_pattern(unsigned vertices, const vector<unsigned> &sizes, vector<map<Key,MismatchInfo> > &hash, float &matches);
+
+	/** Adds a hyperedge label to a hyperedge set, or only counts it on single-labeled hypergraphs. */
+	inline void insert_hyperedge(char hyperedge_label, vector<char> &hyperedge_labels, unsigned &size)  {
+		if (!single_label)
+			insert_hyperedge_label(hyperedge_label, hyperedge_labels);
+		else if (size == 0 || !DISABLE_MULTIPLICITY)
+			size++;
+	}
+
 	/** Returns the counts of induced labeled hypergraphlets on a rooted neighborhood. */
 	vector<map<Key,MismatchInfo> > get_induced_hypergraphlets_counts(SimpleHypergraph &hg, unsigned hg_root);
+
+	/** Returns the counts of each induced hypergraphlet type on a rooted neighborhood of a single-labeled hypergraph. */
+	vector<float> get_induced_type_counts(SimpleHypergraph &hg, unsigned hg_root);
+
+	/** Adds the induced hypergraphlets with 2 to 4 vertices on a rooted neighborhood to hash, or to dense type counts on a single-labeled hypergraph. */
+	void count_induced_hypergraphlets(SimpleHypergraph &hg, unsigned hg_root, vector<map<Key,MismatchInfo> > &hash, double *type_counts);
     
     /** Returns the counts of labeled hypergraphlets on a rooted neighborhood. */
 	vector<map<Key,MismatchInfo> > get_hypergraphlets_counts(SimpleHypergraph &hg, unsigned hg_root);
 
+    /** Counts the hypergraphlets of each representative vertex of interest, in parallel when several threads are set. */
+    void count_root_hypergraphlets(vector<vector<map<Key,MismatchInfo> > > &counts);
+
+    /** Counts the hypergraphlets rooted at each of the given vertices, in parallel when several threads are set. */
+    void count_vertices_hypergraphlets(const vector<unsigned> &vertices, vector<vector<map<Key,MismatchInfo> > > &counts);
+
+    /** Splits the given vertices into those counted one per thread and the hubs split across all threads. */
+    void split_hub_vertices(const vector<unsigned> &vertices, vector<unsigned> &hubs, vector<unsigned> &others);
+
+    /** Counts the hypergraphlet types of each representative vertex of interest of a single-labeled hypergraph. */
+    void count_root_types(vector<vector<float> > &counts);
+
+    /** Returns the counts of each hypergraphlet type rooted at vertex v of a single-labeled hypergraph. */
+    vector<float> get_vertex_type_counts(unsigned v);
+
+    /** Whether the kernel only needs the count of each hypergraphlet type (single labels, induced hypergraphlets, no label substitutions). */
+    inline bool count_types_only()  { return single_label && ENABLE_INDUCED_HYPERGRAPHLETS && set_k((HYPERGRAPHLETS_TYPES-1), SF) == 0 && ELM == 0; }
+
+    /** Returns the counts of labeled hypergraphlets rooted at the i-th vertex of interest. */
+    vector<map<Key,MismatchInfo> > get_root_hypergraphlets_counts(unsigned i);
+
+    /** Returns the counts of labeled hypergraphlets rooted at vertex v. */
+    vector<map<Key,MismatchInfo> > get_vertex_hypergraphlets_counts(unsigned v);
+
     /** Adds the counts for inexact hypergraphlets based on vertex label substitutions. */
     void add_vertex_label_mismatch_counts(map<Key,MismatchInfo> &hash, map<Key,MismatchInfo> &mismatch_hash, unsigned long hg_type, int VLM, bool option);
 
@@ -138,6 +303,54 @@ private:
     /** Adds the counts for inexact hypergraphlets based on 2-edge insertions and deletions. */
     void add_2_edge_mismatch_counts(vector<map<Key,MismatchInfo> > &hash);
 
+    /** Returns the feature vector of exact and inexact hypergraphlets within ED combined edit operations. */
+    map<Key,float> get_edit_distance_features(vector<map<Key,MismatchInfo> > &hash);
+
+    /** Returns the feature vector of exact and label substitution hypergraphlets of all types. */
+    map<Key,float> get_label_mismatch_features(vector<map<Key,MismatchInfo> > &hash);
+
+    /** Maps each vertex of interest to the first one with an isomorphic rooted neighborhood (same label and incident hyperedges). */
+    void group_isomorphic_roots();
+
+    /** Groups the remaining vertices of interest whose hypergraphlet counts are identical (before label and hyperedge mismatches are added). */
+    void group_identical_counts(vector<vector<map<Key,MismatchInfo> > > &counts);
+
+    /** Groups the remaining vertices of interest whose type counts are identical. */
+    void group_identical_type_counts(vector<vector<float> > &counts);
+
+    /** Groups the remaining vertices of interest whose feature vectors are identical. */
+    void group_identical_features(vector<map<Key,float> > &features);
+
+    /** Fills the kernel matrix entries of vertices of interest grouped with an earlier one from the entries of their representatives. */
+    void copy_grouped_rows();
+
+    /** Allocates and zeroes the kernel matrix rows of training and query vertices. */
+    void resize_hyperkernel();
+
+    /** Resizes the kernel matrix to a lower triangle of the given number of rows, keeping existing values. */
+    void resize_hyperkernel_rows(unsigned size);
+
+    /** Identifies a kernel and its parameters, so that a checkpoint is only resumed by the same computation. */
+    string get_checkpoint_tag(const char *kernel);
+
+    /** Identifies the kernel parameters and counting options that the counts and feature vectors depend on. */
+    string get_parameters_tag();
+
+    /** Identifies the features and the hypergraph files of stored feature vectors, for the first line of a features file. */
+    string get_features_tag();
+
+    /** Loads the kernel, the grouping of vertices of interest and the counts of the remaining hypergraphlet types from a matching checkpoint, and sets the next type to process. */
+    bool resume_checkpoint(string tag, unsigned long &hg_type);
+
+    /** Writes a checkpoint before the given hypergraphlet type is processed, if the checkpoint interval has elapsed. */
+    void save_checkpoint(string tag, unsigned long hg_type);
+
+    /** Removes the checkpoint of a completed kernel. */
+    void clear_checkpoint();
+
+    /** Clears the cached mismatch neighborhoods, unless they are kept across kernels. */
+    void clear_mismatch_neighborhoods();
+
     /** Normalizes the kernel matrix using the method for normalizing spectral kernel matrices. */
     void normalize_spectral(map<Key,MismatchInfo> &, unsigned long hg_type);
 
@@ -146,15 +359,20 @@ private:
 
     /** Normalizes the kernel matrix using the method for normalizing the spectral kernel matrix. */
     void normalize_spectral(vector<map<Key,MismatchInfo> >&);
+
+    /** Normalizes dense type counts the same way (single-labeled hypergraphs). */
+    void normalize_spectral(vector<float> &counts);
      
     /** Computes hypergraphlet distance between two vector of hypergraphlet counts. */
     float distance_hash_join(vector<map<Key,MismatchInfo> >, vector<map<Key,MismatchInfo> >);
 
     // Data members.
-    bool NORMALIZE, VERBOSE;
+    bool NORMALIZE, VERBOSE, KEEP_COUNTS, FUSED;
     float SF;
 	int ELM;
     unsigned EM;
+    unsigned ED;
+    vector<float> ED_WEIGHTS;
     string ALPHABET;
     string ALPHABET_ROOT;
     string EDGES_ALPHABET;
@@ -162,12 +380,36 @@ private:
     vector<int>         labels;
     SimpleHypergraph    hypergraph;
     vector<unsigned>    roots;       // Vertices of interest.
-    map<string,float>       sim_vlm_matrix;    
+    unsigned            train_size;  // Vertices of interest before any query vertices.
+    unsigned            THREADS;
+    unsigned            SAMPLES;     // Vertices sampled per root and per extension of each level, 0 for exact counts.
+    VertexOrder         VERTEX_ORDER;
+    string              hypergraph_files;   // Input files and duality of the hypergraph, without delta files.
+    string              hypergraph_source;  // Input files, duality and delta files of the hypergraph, for checkpoint tags.
+    string              VERTEX_SYMBOLS, EDGE_SYMBOLS;  // Labels that may appear in keys besides the hypergraph labels.
+    string              CHECKPOINT;  // Checkpoint file, empty for none.
+    unsigned            CHECKPOINT_INTERVAL;
+    bool                RESUME;
+    time_t              last_checkpoint;
+    bool                single_label;  // All vertices and all hyperedges share one label.
+    char                single_vertex_label, single_edge_label;
+    vector<PatternType> single_label_types;  // Type of each pattern of non-empty hyperedge sets, for 2, 3 and 4 vertices.
+    vector<map<Key,MismatchInfo> > single_label_hash;     // The only key of each hypergraphlet type in a single-labeled hypergraph.
+    vector<vector<unsigned> > vertex_neighbors;           // Neighbors of each vertex in original id order, computed once per hypergraph.
+    double              hub_cost;       // Hub threshold over the vertices of interest, -1 until computed.
+    bool                counting_hubs;  // Hubs picked by split_hub_vertices are being counted.
+    vector<unsigned>    root_class;  // Index of the first vertex of interest with an isomorphic rooted neighborhood or identical counts.
+    map<string,float>       sim_vlm_matrix;
+    string                  sim_vlm_matrix_file;    
 	map<string,float>       sim_elm_matrix;    
+	string                  sim_elm_matrix_file;
     vector<vector<map<Key,MismatchInfo> > > hashes;
+    map<unsigned, vector<map<Key,MismatchInfo> > > exact_hashes;  // Exact counts of each vertex of interest, kept across kernels.
     vector<vector<float> >  hyperkernel;
-    map<Key, list<Key> >    vl_mismatch_neighborhood;
-    map<Key, list<Key> >    el_mismatch_neighborhood;
+    vector<map<Key,float> > root_features;  // Feature vectors of the vertices of interest, for incremental kernels.
+    map<pair<unsigned long, int>, map<Key, list<Key> > > vl_mismatch_neighborhood;  // Per hypergraphlet type and number of mismatches.
+    map<pair<unsigned long, int>, map<Key, list<Key> > > el_mismatch_neighborhood;
+    map<pair<unsigned long, Key>, vector<EditOperation> > ed_neighborhood;
 };
 
 #endif
@@ -0,0 +1,103 @@
+#include "kernelmatrix.h"
+#include "hyperkernel.h"
+
+
+// Vertices, feature vectors and row cache of a KernelMatrix, kept out of the public header.
+class KernelRows  {
+public:
+    KernelRows(const vector<unsigned> &vertices_of_interest, unsigned max_rows) : vertices(vertices_of_interest), cache_rows(max_rows), row_hits(0), row_misses(0) {}
+
+    vector<unsigned> vertices;
+    vector<FeatureVector> vertex_features;
+    vector<bool> extracted;
+
+    unsigned cache_rows;                // Maximum number of cached rows.
+    list<unsigned> lru_rows;            // Cached rows, most recently used first.
+    map<unsigned, pair<vector<float>, list<unsigned>::iterator> > cached_rows;
+    unsigned long row_hits, row_misses;
+};
+
+
+/*********************** FeatureExtractor methods ***********************/
+FeatureVector FeatureExtractor::extract(unsigned v)  {
+    return hk.get_vertex_features(v);
+}
+
+unsigned FeatureExtractor::get_number_vertices()  {
+    return hk.get_number_vertices();
+}
+
+
+/*********************** KernelMatrix methods ***********************/
+KernelMatrix::KernelMatrix(FeatureExtractor &extractor, const vector<unsigned> &vertices_of_interest, unsigned max_rows) : fe(extractor), rows(new KernelRows(vertices_of_interest, max_rows))  {
+    if (rows->cache_rows == 0)
+        rows->cache_rows = 1;
+
+    for (unsigned i=0; i<rows->vertices.size(); i++)  {
+        if (rows->vertices[i] >= fe.get_number_vertices())  {
+            cerr << "ERROR: Vertex " << rows->vertices[i] << " is not in the hypergraph." << endl;  exit(1);
+        }
+    }
+    rows->vertex_features.resize(rows->vertices.size());
+    rows->extracted.resize(rows->vertices.size(), false);
+}
+
+KernelMatrix::~KernelMatrix()  {
+    delete rows;
+}
+
+unsigned KernelMatrix::size() const  {
+    return rows->vertices.size();
+}
+
+unsigned long KernelMatrix::get_row_hits() const  {
+    return rows->row_hits;
+}
+
+unsigned long KernelMatrix::get_row_misses() const  {
+    return rows->row_misses;
+}
+
+const FeatureVector &KernelMatrix::features(unsigned i)  {
+    if (!rows->extracted[i])  {
+        rows->vertex_features[i] = fe.extract(rows->vertices[i]);
+        rows->extracted[i] = true;
+    }
+    return rows->vertex_features[i];
+}
+
+float KernelMatrix::entry(unsigned i, unsigned j)  {
+    // Use a cached row if either one is available; the matrix is symmetric.
+    map<unsigned, pair<vector<float>, list<unsigned>::iterator> >::iterator it = rows->cached_rows.find(i);
+    if (it != rows->cached_rows.end())
+        return it->second.first[j];
+    it = rows->cached_rows.find(j);
+    if (it != rows->cached_rows.end())
+        return it->second.first[i];
+
+    return features_dot_product(features(i), features(j));
+}
+
+const vector<float> &KernelMatrix::row(unsigned i)  {
+    map<unsigned, pair<vector<float>, list<unsigned>::iterator> >::iterator it = rows->cached_rows.find(i);
+    if (it != rows->cached_rows.end())  {
+        rows->row_hits++;
+        rows->lru_rows.splice(rows->lru_rows.begin(), rows->lru_rows, it->second.second);
+        return it->second.first;
+    }
+    rows->row_misses++;
+
+    // Evict the least recently used row.
+    if (rows->cached_rows.size() >= rows->cache_rows)  {
+        rows->cached_rows.erase(rows->lru_rows.back());
+        rows->lru_rows.pop_back();
+    }
+
+    vector<float> values(rows->vertices.size());
+    for (unsigned j=0; j<rows->vertices.size(); j++)
+        values[j] = entry(i, j);
+
+    rows->lru_rows.push_front(i);
+    it = rows->cached_rows.insert(make_pair(i, make_pair(values, rows->lru_rows.begin()))).first;
+    return it->second.first;
+}
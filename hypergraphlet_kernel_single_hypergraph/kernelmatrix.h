@@ -0,0 +1,68 @@
+/**
+ * Library interface to hypergraphlet kernels: feature vectors of
+ * vertices and a kernel matrix whose entries and rows are computed
+ * on demand, so that solvers touching only a few rows never build
+ * the full matrix.
+ *
+ */
+
+#ifndef __KERNELMATRIX_H__
+#define __KERNELMATRIX_H__
+
+#include <stdint.h>
+#include <map>
+#include <utility>
+#include <vector>
+
+class HyperKernels;
+class KernelRows;
+
+
+/** Sparse feature vector of a vertex, indexed by feature id (hypergraphlet type and label code). */
+typedef std::map<std::pair<uint64_t, uint64_t>, float> FeatureVector;
+
+/** Maps vertices of a hypergraph to their feature vectors, for the parameters set on a (read and configured) HyperKernels object. */
+class FeatureExtractor  {
+public:
+    FeatureExtractor(HyperKernels &hyperkernels) : hk(hyperkernels) {}
+    ~FeatureExtractor()  {}
+
+    /** Returns the feature vector of vertex v. */
+    FeatureVector extract(unsigned v);
+
+    unsigned get_number_vertices();
+
+private:
+    HyperKernels &hk;
+};
+
+/** Kernel matrix over a list of vertices, computed lazily from their feature vectors and keeping the most recently used rows. */
+class KernelMatrix  {
+public:
+    KernelMatrix(FeatureExtractor &extractor, const std::vector<unsigned> &vertices, unsigned cache_rows);
+    ~KernelMatrix();
+
+    unsigned size() const;
+
+    /** Returns the kernel value between the i-th and j-th vertices. */
+    float entry(unsigned i, unsigned j);
+
+    /** Returns the kernel values between the i-th vertex and all vertices. Valid until the next call to row(). */
+    const std::vector<float> &row(unsigned i);
+
+    /** Returns the feature vector of the i-th vertex, extracting it on first use. */
+    const FeatureVector &features(unsigned i);
+
+    unsigned long get_row_hits() const;
+
+    unsigned long get_row_misses() const;
+
+private:
+    KernelMatrix(const KernelMatrix &);
+    KernelMatrix &operator=(const KernelMatrix &);
+
+    FeatureExtractor &fe;
+    KernelRows *rows;                   // Vertices, extracted feature vectors and cached rows.
+};
+
+#endif
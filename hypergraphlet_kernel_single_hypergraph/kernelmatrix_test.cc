@@ -0,0 +1,77 @@
+/**
+ * Example client of the hyperkernel library (see kernelmatrix.h). It
+ * computes the Standard Hypergraphlet kernel over a list of vertices
+ * and checks the entries and cached rows of a KernelMatrix against
+ * the full matrix of feature vector dot products.
+ *
+ * Usage: kernelmatrix_test HG_PATH L_PATH E_PATH V1 V2 V3 ...
+ *
+ */
+
+#include "kernelmatrix.h"
+#include "hyperkernel.h"
+#include "string.h"
+
+
+// Checks a kernel matrix row against the full matrix.
+void check_row(KernelMatrix &km, const vector<vector<float> > &full, unsigned i)  {
+    const vector<float> &values = km.row(i);
+    for (unsigned j=0; j<full.size(); j++)  {
+        if (values[j] != full[i][j])  {
+            cerr << "ERROR: Row " << i << " has " << values[j] << " at column " << j << " instead of " << full[i][j] << "." << endl;  exit(1);
+        }
+    }
+}
+
+int main(int argc, char* argv[])  {
+    if (argc < 7)  {
+        cerr << "Usage: kernelmatrix_test HG_PATH L_PATH E_PATH V1 V2 V3 ..." << endl;  exit(1);
+    }
+    vector<unsigned> vertices;
+    for (int i=4; i<argc; i++)
+        vertices.push_back(to_i(argv[i]));
+
+    HyperKernels hk;
+    hk.set_number_vertex_label_mismatches(0.0);
+    hk.set_number_edge_label_mismatches(0);
+    hk.read_hypergraph(argv[2], argv[3], argv[1], vertices);
+
+    // Full matrix from the feature vectors of all vertices at once.
+    vector<map<Key,float> > features = hk.get_vertices_features(vertices);
+    vector<vector<float> > full(vertices.size(), vector<float>(vertices.size()));
+    for (unsigned i=0; i<vertices.size(); i++)  {
+        for (unsigned j=0; j<vertices.size(); j++)
+            full[i][j] = features_dot_product(features[i], features[j]);
+    }
+
+    FeatureExtractor fe(hk);
+    KernelMatrix km(fe, vertices, 2);
+    if (km.size() != vertices.size())  {
+        cerr << "ERROR: Kernel matrix has " << km.size() << " vertices instead of " << vertices.size() << "." << endl;  exit(1);
+    }
+    for (unsigned i=0; i<vertices.size(); i++)  {
+        for (unsigned j=0; j<vertices.size(); j++)  {
+            if (km.entry(i, j) != full[i][j])  {
+                cerr << "ERROR: Entry (" << i << ", " << j << ") is " << km.entry(i, j) << " instead of " << full[i][j] << "." << endl;  exit(1);
+            }
+        }
+    }
+
+    // With two cached rows, rows 0 and 1 are misses, 0 a hit, 2 a miss evicting 1, 0 a hit and 1 a miss again.
+    unsigned order[] = {0, 1, 0, 2, 0, 1};
+    for (unsigned r=0; r<6; r++)
+        check_row(km, full, order[r]);
+    if (km.get_row_hits() != 2 || km.get_row_misses() != 4)  {
+        cerr << "ERROR: Row cache has " << km.get_row_hits() << " hits and " << km.get_row_misses() << " misses instead of 2 and 4." << endl;  exit(1);
+    }
+
+    // Entries of cached rows are read from the cache.
+    for (unsigned j=0; j<vertices.size(); j++)  {
+        if (km.entry(1, j) != full[1][j] || km.entry(j, 0) != full[j][0])  {
+            cerr << "ERROR: Cached entries of rows 0 and 1 differ from the full matrix." << endl;  exit(1);
+        }
+    }
+
+    cout << "KernelMatrix of " << vertices.size() << " vertices matches the full matrix (" << km.get_row_hits() << " row hits, " << km.get_row_misses() << " misses)." << endl;
+    return 0;
+}
@@ -25,8 +25,10 @@
 #include <limits.h>
 #include "hyperkernel.h"
 #include "string.h"
+#include <sys/time.h>
 #include <iostream>
 #include <fstream>
+#include <algorithm>
 using namespace std;
 
 
@@ -39,11 +41,23 @@ void print_help()  {
     cout << "  -t TYPE    Kernel type (0-Cumulative Random Walk, 1-Standard Random Walk, 2-Standard Hypergraphlet, 3-Label Substitutions Hypergraphlet, 4-Edge Indels Hypergraphlet, 5-Edit Distance Hypergraphlet).\n";
     cout << "             Defaults to standard hypergraphlet.\n\n";
 
-    cout << "  -z TASK    Task type (0-Vertex classification, 1-Edge classification)\n";
-    cout << "             Defaults to vertex classification.\n\n";
+    cout << "  -z TASK    Task type (0-Vertex classification, 1-Edge classification, 2-Link prediction)\n";
+    cout << "             Defaults to vertex classification.\n";
+    cout << "             For link prediction, each line of the -p and -n lists is a tab-separated pair of candidate vertices. Each vertex is counted once;\n";
+    cout << "             kernel outputs hold k(a,c)k(b,d)+k(a,d)k(b,c) for pairs (a,b) and (c,d). SVML outputs give each pair the elementwise sum\n";
+    cout << "             (0:F1:F2:VALUE) and product (1:F1:F2:VALUE) of the feature vectors of a and b.\n";
+    cout << "  -y         Link prediction SVML outputs give each pair the symmetric tensor product of the feature vectors of a and b instead, as\n";
+    cout << "             F1:F2:G1:G2:VALUE entries for the feature pair (F1:F2, G1:G2), whose dot products are the pairwise kernel. A pair then has\n";
+    cout << "             up to |F_a|*|F_b| entries (over a million for well-connected vertices), so this only suits small candidate sets.\n\n";
 
     cout << "  -p FILE    List of positive (vertices) examples.\n";
     cout << "  -n FILE    List of negative (vertices) examples.\n";
+    cout << "             Several tasks over the same hypergraph are given by repeating -p and -n (one pair per task). Vertices of interest shared by\n";
+    cout << "             tasks are counted only once, and the task name (i.e. positive list file name) is appended to each output file name.\n";
+    cout << "  -q FILE    List of query vertices, compared only against the (training) vertices of the -p and -n lists.\n";
+    cout << "             The kernel matrix then holds the training block followed by one row of training columns per query vertex,\n";
+    cout << "             and query vertices get label 0 in SVML and labels outputs. With -A and -f, the training vertices are those of the\n";
+    cout << "             features file (grown with any new -p and -n vertices), and only the query rows are computed from stored vectors.\n";
     cout << "  -g HG_FILE Hypergraph file without file extension.\n";
     cout << "  -l L_FILE  Vertex labels file for input hypergraph without file extension.\n\n";
     cout << "  -e E_FILE  Edge labels file for input hypergraph without file extension.\n\n";
@@ -78,91 +92,777 @@ void print_help()  {
     cout << "  -m EDGMIS  Total number of edge insertions or deletions allowed between hypergraphlets. (Needed for Edge Indels and Edit Distance Hyperkernels)\n";
     cout << "             Defaults to 0.\n\n";
 
+    cout << "  -d DIST    Total number of edit operations (vertex label substitutions, edge label substitutions and edge indels) allowed between hypergraphlets. (Needed for Edit Distance Hyperkernel)\n";
+    cout << "             Explores the combined edit neighborhood in a single pass for any DIST; -K, -M and -m still bound each kind of operation.\n";
+    cout << "             Defaults to 0 (i.e. use the original edit distance implementation with -m operations).\n\n";
+
+    cout << "  -w WEIGHTS Comma-separated weights for hypergraphlets at edit distance 0,1,...,DIST (e.g. 1,0.5,0.25). (Needed for Edit Distance Hyperkernel with -d)\n";
+    cout << "             Defaults to 1 for every edit distance.\n\n";
+
     cout << "  -V ALPHA   Vertex labels alphabet over problem statement is defined (i.e. all possible labels for a vertex). (Needed for Label Substitutions and Edit Distance Hyperkernels)\n\n";
 
     cout << "  -E ALPHA   Edge labels alphabet over problem statement is defined (i.e. all possible labels for an edge). (Needed for Label Substitutions, Edge Indels and Edit Distance Hyperkernels)\n\n";
 
+    cout << "  -F CONFIGS File with one kernel configuration per line, given with the kernel-specific options above (e.g. -t 3 -K 0.34 -M 1 -k LM.dat).\n";
+    cout << "             Exact hypergraphlets are counted once per vertex of interest and shared by all configurations; options not given on a line default to the command line ones.\n\n";
+
+    cout << "  -G GRID    Grid of kernel-specific options to sweep, given as OPTION=VALUE,VALUE,... separated by semicolons (e.g. \"K=0,0.34;M=1,2;N=0,1\").\n";
+    cout << "             Options t, I, R, S, P, K, M, m, d and N (0 or 1) can be swept. Each kernel configuration is computed for every grid point, and the\n";
+    cout << "             option values are appended to its output file name (e.g. LM_K0.34_M1.dat). Exact counts and mismatch neighborhoods are shared by all points.\n\n";
+
+    cout << "  -A KERNEL  Existing kernel matrix to grow with the vertices of the -p and -n lists that it does not cover yet. (Needs -f)\n";
+    cout << "             Only the rows of new vertices are computed, as dot products of feature vectors, and the grown matrix is written to -k.\n";
+    cout << "             Supports the Standard, Label Substitutions and Edit Distance (with -d) hyperkernels.\n\n";
+
+    cout << "  -f FEATURES File with the feature vectors of the vertices covered by the -A kernel matrix, in matrix order. It is updated\n";
+    cout << "             with the new vertices; if it does not exist, the kernel matrix is computed from scratch. Its first line tags the kernel\n";
+    cout << "             options and hypergraph files it was computed with, and a file written with other ones is rejected.\n\n";
+
+    cout << "  -u DELTA   Hyperedges to add (+ LABEL V1 V2 ...) or remove (- EDGE), one per tab-separated line, before growing the -A kernel matrix.\n";
+    cout << "             Only vertices within 3 hops of an edited hyperedge are recounted, and only their rows and columns are recomputed.\n";
+    cout << "             The updated hypergraph is written back to the -g, -l and -e files, so deltas are cumulative: each one applies to the\n";
+    cout << "             hypergraph left by the previous ones, together with the -A kernel and -f features they grew. Removed hyperedges keep\n";
+    cout << "             their ids and added ones get the next ids. Needs vertex classification.\n\n";
+
+    cout << "  -D         Server mode: keeps the hypergraph and the feature vectors of requested vertices in memory, and answers one request per line\n";
+    cout << "             of standard input (features V | row V U1 U2 ... | topk K V | stats | quit). topk searches the vertices of the -p, -n and -q lists.\n";
+    cout << "             Supports the Standard, Label Substitutions and Edit Distance (with -d) hyperkernels, where kernel values are feature dot products.\n";
+    cout << "             Requests already waiting on standard input are answered together: their missing feature vectors are computed on the -T threads.\n\n";
+
     cout << "  -c LABELS  Output file for each example class label.\n\n";   
+
+    cout << "  -H SIZES   Sizes of the hypergraphlets counted, as digits from 1 to 4 (e.g. 234). Defaults to 1234.\n";
+    cout << "  -X         Counts hypergraphlets without partial decompositions of large hyperedges (no induced subhypergraphs).\n";
+    cout << "  -U         Restricts hypergraphlets from having equivalent hyperedges with the same label.\n";
+    cout << "  -o FORMAT  Kernel matrix output format (0-Triangular binary, 1-Triangular text, 2-Square text). Defaults to square text.\n\n";
+
+    cout << "  -x         Computes the Label Substitutions (and Standard) hyperkernel root by root: each vertex of interest expands the mismatches\n";
+    cout << "             of all hypergraphlet types into one feature vector, and a single pass joins the vectors (in parallel with -T). Keeps the\n";
+    cout << "             mismatch neighborhoods of all types in memory. Defaults to one pass over all vertices per hypergraphlet type.\n\n";
+
+    cout << "  -C FILE    Checkpoint file for the Label Substitutions and Edit Distance (without -d) hyperkernels. A binary snapshot of the\n";
+    cout << "             partial kernel matrix and of the counts of the hypergraphlet types not processed yet is written at most every -W\n";
+    cout << "             seconds, and removed once the kernel is complete.\n";
+    cout << "  -W SECONDS Interval between checkpoints. Defaults to 600 seconds.\n";
+    cout << "  -r         Resume from the checkpoint, if it was written by the same kernel and counting options over the same hypergraph files, vertex order and vertices of interest.\n\n";
+
+    cout << "  -O ORDER   Vertex order (0-Input, 1-BFS (reverse Cuthill-McKee), 2-Degree). Renumbers vertices and hyperedges at load time so that\n";
+    cout << "             the enumeration from a root touches nearby memory; all inputs and outputs keep the original ids. The enumeration\n";
+    cout << "             still compares vertices by original id, so outputs are the same for every order.\n";
+    cout << "             Defaults to input order.\n\n";
+
+    cout << "  -B SAMPLES Sample budget: each root extends at most SAMPLES sampled first-level neighbors i, SAMPLES vertices j from each i\n";
+    cout << "             and SAMPLES vertices k from each j. Counts are weighted by the inverse of their sampling probability (unbiased),\n";
+    cout << "             and the 95% confidence interval of each estimate with sampled first-level neighbors is reported. Default: exact counts.\n\n";
+
+    cout << "  -T THREADS Number of threads counting hypergraphlets (default: 1). Vertices of interest are counted in parallel, and hub vertices\n";
+    cout << "             are split across threads by first-level neighbor. Needs a build with OpenMP.\n\n";
    
     cout << "  -v         Verbose (prints progress messages).\n\n"; 
 }
 
+typedef enum kerneltype  {
+    RANDOM_WALK_CUMULATIVE,
+    RANDOM_WALK,
+    STANDARD_GRAPHLET,
+    LABEL_MISMATCH,
+    EDGE_MISMATCH,
+    EDIT_DISTANCE
+ } KernelType;
+
+typedef enum tasktype  {
+    VERTEX_CLASSIFICATION,
+    EDGE_CLASSIFICATION,
+    LINK_PREDICTION
+} TaskType;
+
+typedef enum outformat  {
+    KERNEL,
+    SPARSE_SVML
+ } OutputFormat;
+
+// Kernel type, output file and kernel-specific parameters of one hyperkernel.
+struct KernelConfig  {
+    OutputFormat format;
+    KernelType hk_type;
+    string output_file;
+
+    // Random Walk Hyperkernel Parameters
+    int steps;
+    double restart;
+
+    // Label Substitutions and Edit Distance Hyperkernels Parameters
+    float vlabel_mismatches;
+    int elabel_mismatches;
+    string sim_vlm_matrix_file, sim_elm_matrix_file;
+
+    // Edge Indels and and Edit Distance Hyperkernels Parameter
+    unsigned edgmis;
+
+    // Generalized Edit Distance Hyperkernel Parameters
+    unsigned edit_distance;
+    vector<float> edit_distance_weights;
+
+    bool normalize;
+
+    KernelConfig() : format(KERNEL), hk_type(STANDARD_GRAPHLET), steps(100000), restart(0.3), vlabel_mismatches(0.0), elabel_mismatches(1), edgmis(1), edit_distance(0), normalize(false) {}
+};
+
+// Parses the kernel-specific option at argv[i]. Returns false if it is not a kernel-specific option.
+bool parse_kernel_option(KernelConfig &config, char* argv[], int &i)  {
+    switch ((argv[i])[1])  {
+        case 't': 
+            i++; 
+            switch (to_i(argv[i]))  {
+                case 0:
+                    config.hk_type=RANDOM_WALK_CUMULATIVE;
+                    break;
+                case 1:
+                    config.hk_type=RANDOM_WALK;
+                    break;
+                case 2:
+                    config.hk_type=STANDARD_GRAPHLET;
+                    break;
+                case 3:
+                    config.hk_type=LABEL_MISMATCH;
+                    break;
+                case 4:
+                    config.hk_type=EDGE_MISMATCH;
+                    break;
+                case 5:
+                    config.hk_type=EDIT_DISTANCE;
+                    break;
+                default:
+                    config.hk_type=STANDARD_GRAPHLET;
+            }
+            break;
+        case 'k': i++; config.format=KERNEL; config.output_file=argv[i]; break;
+        case 's': i++; config.format=SPARSE_SVML; config.output_file=argv[i]; break;
+        // Hyperkernel-specific parameters                    
+        case 'I': i++; config.steps=to_i(argv[i]); break;
+        case 'R': i++; config.restart=to_f(argv[i]); break;
+
+        case 'S': i++; config.sim_vlm_matrix_file=argv[i]; break;
+        case 'P': i++; config.sim_elm_matrix_file=argv[i]; break;
+        case 'K': 
+            i++; 
+            config.vlabel_mismatches=to_f(argv[i]);
+            if(config.vlabel_mismatches < 0.0 || config.vlabel_mismatches > 1.0)  { 
+                cerr << "ERROR: Fraction of nodes allowed to have vertex label mismatches must be 0<=K<=1, but you entered " << argv[i] << endl;
+                print_help();  exit(1);
+            }
+            break;
+        case 'M':
+            i++;
+            config.elabel_mismatches=to_i(argv[i]);
+            if(config.elabel_mismatches < 0)  {
+                cerr << "ERROR: Total number of edge label mismatches must be non-negative, but you entered " << argv[i] << endl;
+                print_help();  exit(1);
+            }
+            break;
+        case 'm': i++; config.edgmis=to_i(argv[i]); break;
+        case 'd': i++; config.edit_distance=to_i(argv[i]); break;
+        case 'w':
+            i++;
+            {
+                config.edit_distance_weights.clear();
+                vector<string> tokens = split(argv[i], ',');
+                for (unsigned w=0; w<tokens.size(); w++)
+                    config.edit_distance_weights.push_back(to_f(strip(tokens[w])));
+            }
+            break;
+        case 'N': config.normalize=true; break;
+        default:
+            return false;
+    }
+    return true;
+}
+
+// Checks the parameters of a kernel configuration and sets the default similarity matrices.
+void check_kernel_config(KernelConfig &config, const string &vertices_alphabet, const string &root_alphabet, bool serve)  {
+    if (0 == config.output_file.size() && !serve)  {
+        cerr << "ERROR: Output file name not specified." << endl;  print_help();  exit(1);
+    }
+
+    // The original label substitutions and edit distance implementations are hard-coded for either 1 or 2 operations.
+    if (!(config.hk_type == EDIT_DISTANCE && config.edit_distance > 0))  {
+        if (config.elabel_mismatches > 2)  {
+            cerr << "ERROR: Total number of edge label mismatches must be either 1 or 2, but you entered " << config.elabel_mismatches << endl;
+            print_help();  exit(1);
+        }
+        if (config.edgmis > 2)  {
+            cerr << "ERROR: Total number of edge insertions and deletions must be either 1 or 2, but you entered " << config.edgmis << endl;
+            print_help();  exit(1);
+        }
+    }
+
+    if (0 == config.sim_vlm_matrix_file.size() && (config.hk_type == LABEL_MISMATCH || config.hk_type == EDIT_DISTANCE))  {
+        //Use default node labels similarity matrix
+        config.sim_vlm_matrix_file = "user_defined.matrix";
+    }
+
+    if (0 == config.sim_elm_matrix_file.size() && (config.hk_type == LABEL_MISMATCH || config.hk_type == EDGE_MISMATCH || config.hk_type == EDIT_DISTANCE))  {
+        //Use default hyperedge labels similarity matrix
+        config.sim_elm_matrix_file = "user_defined.matrix";
+    }
+
+    if ((config.hk_type == LABEL_MISMATCH || config.hk_type == EDIT_DISTANCE) && config.vlabel_mismatches > 0.0 && (0 == vertices_alphabet.size() || 0 == root_alphabet.size()))  {
+        cerr << "ERROR: Alphabet for the vertex labels not specified. It is required for selected hyperkernel type." << endl;  print_help();  exit(1);
+    }
+}
+
+// Reads one kernel configuration per line (e.g. "-t 3 -K 0.34 -M 1 -k LM.dat"), starting each one from the command line options.
+vector<KernelConfig> read_kernel_configs(string configs_file, const KernelConfig &defaults)  {
+    vector<KernelConfig> configs;
+    string line;
+
+    ifstream f(configs_file.c_str(), ios::in);
+    if (f.fail())  {
+        cerr << "ERROR: Kernel configurations file " << configs_file << " cannot be opened." << endl;  exit(1);
+    }
+    while(getline(f, line))  {
+        if (line.size() > 0)
+            line = strip(line);
+        if (line.size() == 0 || line[0] == '#')
+            continue;
+
+        vector<string> tokens = split(line, ' ');
+        vector<char*> args;
+        for (unsigned j=0; j<tokens.size(); j++)  {
+            if (tokens[j].size() > 0)
+                tokens[j] = strip(tokens[j]);
+            if (tokens[j].size() > 0)
+                args.push_back(&tokens[j][0]);
+        }
+
+        // Every kernel-specific option but -N takes a value.
+        KernelConfig config(defaults);
+        for (int i=0; i<int(args.size()); i++)  {
+            if ((args[i])[0] != '-' || ((args[i])[1] != 'N' && i+1 >= int(args.size())) || !parse_kernel_option(config, &args[0], i))  {
+                cerr << "ERROR: Invalid kernel configuration option " << args[i] << " in " << configs_file << endl;  exit(1);
+            }
+        }
+        configs.push_back(config);
+    }
+    f.close();
+
+    if (configs.size() == 0)  {
+        cerr << "ERROR: No kernel configurations found in " << configs_file << endl;  exit(1);
+    }
+    return configs;
+}
+
+// Returns the file name without directory and extension.
+string file_stem(const string &file)  {
+    string stem(file);
+    if (stem.find_last_of('/') != string::npos)
+        stem = stem.substr(stem.find_last_of('/') + 1);
+    if (stem.find_last_of('.') != string::npos)
+        stem = stem.substr(0, stem.find_last_of('.'));
+    return stem;
+}
+
+// Inserts the suffix before the extension of the output file name, if any (e.g. LM.dat becomes LM_K0.34.dat).
+string add_output_suffix(const string &file, const string &suffix)  {
+    string output_file(file);
+    size_t ext = output_file.find_last_of('.');
+    size_t dir = output_file.find_last_of('/');
+    if (ext != string::npos && (dir == string::npos || ext > dir))
+        output_file.insert(ext, suffix);
+    else
+        output_file += suffix;
+    return output_file;
+}
+
+// Expands each kernel configuration over a grid of kernel-specific options (e.g. "K=0,0.34;M=1,2;N=0,1").
+vector<KernelConfig> expand_kernel_grid(const vector<KernelConfig> &configs, string grid)  {
+    vector<pair<char, vector<string> > > dimensions;
+    unsigned matrix_dimensions = 0;
+
+    vector<string> params = split(grid, ';');
+    for (unsigned j=0; j<params.size(); j++)  {
+        if (params[j].size() > 0)
+            params[j] = strip(params[j]);
+        if (params[j].size() == 0)
+            continue;
+
+        vector<string> tokens = split(params[j], '=');
+        if (tokens.size() == 2 && tokens[0].size() > 0)
+            tokens[0] = strip(tokens[0]);
+        if (tokens.size() != 2 || tokens[0].size() != 1 || string("tIRSPKMmdN").find(tokens[0][0]) == string::npos)  {
+            cerr << "ERROR: Invalid grid parameter " << params[j] << endl;  print_help();  exit(1);
+        }
+
+        vector<string> values;
+        vector<string> value_tokens = split(tokens[1], ',');
+        for (unsigned v=0; v<value_tokens.size(); v++)  {
+            if (value_tokens[v].size() > 0)
+                value_tokens[v] = strip(value_tokens[v]);
+            if (value_tokens[v].size() > 0)
+                values.push_back(value_tokens[v]);
+        }
+        if (values.size() == 0)  {
+            cerr << "ERROR: No values given for grid parameter " << params[j] << endl;  print_help();  exit(1);
+        }
+
+        // Similarity matrices vary slowest, so the mismatch neighborhoods built with each one are reused by all other points.
+        if (tokens[0][0] == 'S' || tokens[0][0] == 'P')  {
+            dimensions.insert(dimensions.begin() + matrix_dimensions, make_pair(tokens[0][0], values));
+            matrix_dimensions++;
+        }
+        else
+            dimensions.push_back(make_pair(tokens[0][0], values));
+    }
+
+    vector<KernelConfig> points(configs);
+    for (unsigned j=0; j<dimensions.size(); j++)  {
+        char option = dimensions[j].first;
+        vector<KernelConfig> expanded;
+
+        for (unsigned p=0; p<points.size(); p++)  {
+            for (unsigned v=0; v<dimensions[j].second.size(); v++)  {
+                string value = dimensions[j].second[v];
+                KernelConfig config(points[p]);
+
+                if (option == 'N')  {
+                    if (value != "0" && value != "1")  {
+                        cerr << "ERROR: Grid values for N must be either 0 or 1, but you entered " << value << endl;  print_help();  exit(1);
+                    }
+                    config.normalize = (value == "1");
+                }
+                else  {
+                    string flag = string("-") + option;
+                    char* args[] = {&flag[0], &value[0]};
+                    int i = 0;
+                    parse_kernel_option(config, args, i);
+                }
+
+                // Similarity matrices are named after their file.
+                string suffix = string("_") + option + ((option == 'S' || option == 'P') ? file_stem(value) : value);
+
+                config.output_file = add_output_suffix(config.output_file, suffix);
+                expanded.push_back(config);
+            }
+        }
+        points = expanded;
+    }
+    return points;
+}
+
+// Sets the hyperkernel parameters of the given configuration.
+void configure_kernel(HyperKernels &hk, const KernelConfig &config, TaskType task_type, const string &vertices_alphabet, const string &root_alphabet, const string &edges_alphabet)  {
+    hk.set_normalize(config.normalize);
+
+    switch (config.hk_type)  {
+        case RANDOM_WALK_CUMULATIVE:
+        case RANDOM_WALK:
+            break;
+        case STANDARD_GRAPHLET:
+            hk.set_number_vertex_label_mismatches(0.0);
+            hk.set_number_edge_label_mismatches(0);
+            break;
+        case LABEL_MISMATCH:
+        case EDIT_DISTANCE:
+            hk.set_number_vertex_label_mismatches(config.vlabel_mismatches);
+            hk.set_number_edge_label_mismatches(config.elabel_mismatches);
+            switch (task_type)  {
+                case VERTEX_CLASSIFICATION:
+                case LINK_PREDICTION:
+                    hk.set_vertex_label_mismatches_alphabet(vertices_alphabet);
+                    hk.set_vertex_label_mismatches_root_alphabet(root_alphabet);
+                    hk.set_edge_label_mismatches_alphabet(edges_alphabet);
+                    break;
+                case EDGE_CLASSIFICATION:
+                    hk.set_vertex_label_mismatches_alphabet(edges_alphabet);
+                    hk.set_vertex_label_mismatches_root_alphabet(edges_alphabet);
+                    hk.set_edge_label_mismatches_alphabet(vertices_alphabet);
+                    break;
+            }
+            hk.read_sim_vlm_matrix(config.sim_vlm_matrix_file);
+            hk.read_sim_elm_matrix(config.sim_elm_matrix_file);
+            hk.set_number_edges_mismatches(config.edgmis);
+            hk.set_edit_distance(config.edit_distance);
+            hk.set_edit_distance_weights(config.edit_distance_weights);
+            break;
+        case EDGE_MISMATCH:
+            hk.set_number_edges_mismatches(config.edgmis);
+            switch (task_type)  {
+                case VERTEX_CLASSIFICATION:
+                case LINK_PREDICTION:
+                    hk.set_edge_label_mismatches_alphabet(edges_alphabet);
+                    break;
+                case EDGE_CLASSIFICATION:
+                    hk.set_edge_label_mismatches_alphabet(vertices_alphabet);
+                    break;
+            }
+            break;
+    }
+}
+
+// Computes the kernel matrix of the given configuration over the vertices of interest.
+void compute_kernel(HyperKernels &hk, const KernelConfig &config)  {
+    switch (config.hk_type)  {
+        case RANDOM_WALK_CUMULATIVE:
+            hk.compute_random_walk_cumulative_matrix(config.steps, config.restart);
+            break;
+        case RANDOM_WALK:
+            hk.compute_random_walk_matrix(config.steps, config.restart);
+            break;
+        case STANDARD_GRAPHLET:
+        case LABEL_MISMATCH:
+            hk.compute_label_mismatch_matrix();
+            break;
+        case EDGE_MISMATCH:
+            hk.compute_edge_mismatch_matrix();
+            break;
+        case EDIT_DISTANCE:
+            if (config.edit_distance > 0)
+                hk.compute_generalized_edit_distance_matrix();
+            else if (config.edgmis == 2)
+                hk.compute_edit_distance2_matrix();
+            else
+                hk.compute_edit_distance_matrix();
+            break;
+    }
+}
+
+// Computes the hyperkernel of the given configuration and writes it to its output file.
+void run_kernel(HyperKernels &hk, const KernelConfig &config, TaskType task_type, const string &vertices_alphabet, const string &root_alphabet, const string &edges_alphabet)  {
+    configure_kernel(hk, config, task_type, vertices_alphabet, root_alphabet, edges_alphabet);
+
+    switch (config.format)  {
+        case KERNEL:
+            compute_kernel(hk, config);
+			hk.write_matrix(config.output_file.c_str());
+            break;
+        case SPARSE_SVML:
+            switch (config.hk_type)  {
+                case RANDOM_WALK_CUMULATIVE:
+                    hk.compute_random_walk_cumulative_matrix(config.steps, config.restart);
+                    hk.write_matrix(config.output_file.c_str());
+                    break;
+				case RANDOM_WALK:
+					hk.compute_random_walk_matrix(config.steps, config.restart);
+                    hk.write_matrix(config.output_file.c_str());
+					break;
+				case STANDARD_GRAPHLET:
+				case LABEL_MISMATCH:
+					hk.write_sparse_svml_lm(config.output_file.c_str());
+                    break;
+                case EDGE_MISMATCH:
+					hk.write_sparse_svml_em(config.output_file.c_str());
+                    break;
+                case EDIT_DISTANCE:
+                    if (config.edit_distance > 0)
+                        hk.write_sparse_svml_ged(config.output_file.c_str());
+                    else if (config.edgmis == 2)
+                        hk.write_sparse_svml_ed2(config.output_file.c_str());
+                    else
+                        hk.write_sparse_svml_ed(config.output_file.c_str()); 
+            }
+    }
+}
+
+// Computes the pairwise hyperkernel of the given configuration over candidate vertex pairs and writes it to its output file.
+void run_pair_kernel(HyperKernels &hk, const KernelConfig &config, const vector<pair<unsigned,unsigned> > &pairs, bool tensor, const string &vertices_alphabet, const string &root_alphabet, const string &edges_alphabet)  {
+    configure_kernel(hk, config, LINK_PREDICTION, vertices_alphabet, root_alphabet, edges_alphabet);
+
+    if (config.format == SPARSE_SVML)
+        hk.write_pair_sparse_svml(config.output_file.c_str(), pairs, tensor);
+    else  {
+        compute_kernel(hk, config);
+        hk.write_pair_matrix(config.output_file.c_str(), pairs);
+    }
+}
+
+// Reads the lists of positive and negative candidate pairs of vertices, one tab-separated pair per line.
+void read_example_pairs(const string &pos_file, const string &neg_file, vector<pair<unsigned,unsigned> > &pairs, vector<int> &labels)  {
+    string line;
+
+    for (unsigned f=0; f<2; f++)  {
+        const string &file = (f == 0) ? pos_file : neg_file;
+        ifstream in(file.c_str(), ios::in);
+        if (in.fail())  {
+            cerr << "WARNING: " << (f == 0 ? "Positive" : "Negative") << " file " << file << " cannot be opened." << endl;
+            continue;
+        }
+        while(getline(in, line))  {
+            if (strip(line).size() == 0)
+                continue;
+            vector<string> tokens = split(strip(line), '\t');
+            if (tokens.size() < 2)  {
+                cerr << "ERROR: Invalid pair " << line << " in file " << file << endl;  exit(1);
+            }
+            pairs.push_back(make_pair(to_i(strip(tokens[0])), to_i(strip(tokens[1]))));
+            labels.push_back(f == 0 ? 1 : -1);
+        }
+        in.close();
+    }
+
+    if (pairs.size() < 2)  {
+        cerr << "ERROR: Too few candidate pairs." << endl << endl; print_help(); exit(1);
+    }
+}
+
+// Reads the lists of positive and negative vertices of interest of one task.
+void read_examples(const string &pos_file, const string &neg_file, vector<unsigned> &roots, vector<int> &labels)  {
+    string line;
+
+    ifstream p(pos_file.c_str(), ios::in);
+    if (p.fail()) {
+        cerr << "WARNING: Positive file " << pos_file << " cannot be opened." << endl;
+    }
+    else  {
+        while(getline(p, line))  {
+            vector<string> tokens = split(line, '\t');            
+            roots.push_back(to_i(strip(tokens[0])));
+            labels.push_back(1);
+        }
+    }
+    p.close();
+
+    ifstream n(neg_file.c_str(), ios::in);
+    if (n.fail())  {
+        cerr << "WARNING: Negative file " << neg_file << " cannot be opened." << endl;
+    }
+    else  {
+        while(getline(n, line))  {
+            vector<string> tokens = split(line, '\t');
+            roots.push_back(to_i(strip(tokens[0])));
+            labels.push_back(-1);
+        }
+    }
+    n.close();
+
+    if (roots.size() < 2)  {
+        cerr << "ERROR: Too few vertices of interest." << endl << endl; print_help(); exit(1);
+    }
+}
+
+// Reads a list of query vertices (first column of each line).
+void read_query_vertices(const string &query_file, vector<unsigned> &query_roots)  {
+    string line;
+
+    ifstream q(query_file.c_str(), ios::in);
+    if (q.fail())  {
+        cerr << "ERROR: Query file " << query_file << " cannot be opened." << endl;  exit(1);
+    }
+    while(getline(q, line))  {
+        vector<string> tokens = split(line, '\t');
+        if (tokens.size() > 0 && tokens[0].size() > 0)
+            query_roots.push_back(to_i(strip(tokens[0])));
+    }
+    q.close();
+}
+
+// Number of requests and time spent answering them, for one server command.
+struct RequestStats  {
+    unsigned long requests;
+    double seconds;
+
+    RequestStats() : requests(0), seconds(0.0) {}
+};
+
+double wall_time()  {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+// Computes the feature vectors of the given vertices that are not stored yet, counting them in parallel.
+void store_features(HyperKernels &hk, map<unsigned, map<Key,float> > &feature_store, const set<unsigned> &vertices)  {
+    vector<unsigned> missing;
+    for (set<unsigned>::const_iterator it = vertices.begin(); it != vertices.end(); it++)  {
+        if (feature_store.find(*it) == feature_store.end())
+            missing.push_back(*it);
+    }
+    if (missing.size() == 0)
+        return;
+
+    vector<map<Key,float> > features = hk.get_vertices_features(missing);
+    for (unsigned i=0; i<missing.size(); i++)
+        feature_store[missing[i]].swap(features[i]);
+}
+
+// Answers one request per line of standard input, until "quit" or end of input:
+//   features V       Feature vector of vertex V, as FID1:FID2:VALUE pairs.
+//   row V U1 U2 ...  Kernel values of vertex V against each listed vertex.
+//   topk K V         The K vertices of interest most similar to vertex V, as VERTEX:VALUE pairs.
+//   stats            Number of requests, mean latency per command, throughput and stored feature vectors.
+// Requests already waiting on standard input are answered as one batch: the feature vectors missing for any of them are
+// computed together on all threads, and the dot products of each row and topk request are split across threads.
+void serve_requests(HyperKernels &hk, const vector<unsigned> &roots)  {
+    const unsigned max_batch(1024);
+    map<unsigned, map<Key,float> > feature_store;
+    map<string, RequestStats> stats;
+    unsigned long total_requests(0);
+    double start_time = wall_time();
+    int threads = hk.get_threads();
+    bool quit(false);
+    string line;
+
+    // Unsynchronized streams buffer standard input, so pending requests can be detected.
+    ios::sync_with_stdio(false);
+    while (!quit && getline(cin, line))  {
+        vector<string> lines(1, line);
+        while (lines.size() < max_batch && cin.rdbuf()->in_avail() > 0 && getline(cin, line))
+            lines.push_back(line);
+        double batch_time = wall_time();
+
+        vector<string> commands;
+        vector<vector<unsigned> > batch_args;
+        vector<bool> batch_valid;
+        set<unsigned> vertices;
+        for (unsigned r=0; r<lines.size(); r++)  {
+            line = lines[r];
+            if (line.size() > 0)
+                line = strip(line);
+            vector<string> tokens;
+            vector<string> fields = split(line, ' ');
+            for (unsigned j=0; j<fields.size(); j++)  {
+                if (fields[j].size() > 0)
+                    tokens.push_back(fields[j]);
+            }
+            if (tokens.size() > 0 && tokens[0] == "quit")  {
+                quit = true;
+                lines.resize(r);
+                break;
+            }
+            string command = tokens.size() > 0 ? tokens[0] : "";
+
+            // Every argument is a non-negative integer; all but the number of neighbors in topk are vertices.
+            vector<unsigned> args;
+            bool valid(true);
+            for (unsigned j=1; j<tokens.size(); j++)  {
+                if (tokens[j].find_first_not_of("0123456789") != string::npos)
+                    valid = false;
+                else  {
+                    args.push_back(to_i(tokens[j]));
+                    if (args.back() >= hk.get_number_vertices() && !(command == "topk" && j == 1))
+                        valid = false;
+                }
+            }
+            if (command == "features" && args.size() == 1 && valid)
+                vertices.insert(args[0]);
+            else if (command == "row" && args.size() >= 2 && valid)
+                vertices.insert(args.begin(), args.end());
+            else if (command == "topk" && args.size() == 2 && valid)  {
+                vertices.insert(args[1]);
+                vertices.insert(roots.begin(), roots.end());
+            }
+            lines[r] = line;
+            commands.push_back(command);
+            batch_args.push_back(args);
+            batch_valid.push_back(valid);
+        }
+        store_features(hk, feature_store, vertices);
+
+        for (unsigned r=0; r<lines.size(); r++)  {
+            const string &command = commands[r];
+            const vector<unsigned> &args = batch_args[r];
+            bool valid = batch_valid[r];
+            if (command.size() == 0)
+                continue;
+
+            if (command == "stats" && args.size() == 0 && valid)  {
+                double elapsed = wall_time() - start_time;
+                cout << "requests " << total_requests << " uptime " << elapsed << "s throughput " << (elapsed > 0.0 ? total_requests / elapsed : 0.0) << "/s";
+                for (map<string, RequestStats>::iterator it = stats.begin(); it != stats.end(); it++)
+                    cout << "; " << it->first << " " << it->second.requests << " (mean " << 1000.0 * it->second.seconds / it->second.requests << " ms)";
+                cout << "; stored " << feature_store.size() << endl;
+                continue;
+            }
+            else if (command == "features" && args.size() == 1 && valid)  {
+                const map<Key,float> &features = feature_store[args[0]];
+                for (map<Key,float>::const_iterator it = features.begin(); it != features.end(); it++)
+                    cout << (it == features.begin() ? "" : " ") << it->first.first << ":" << it->first.second << ":" << it->second;
+                cout << endl;
+            }
+            else if (command == "row" && args.size() >= 2 && valid)  {
+                const map<Key,float> &features = feature_store[args[0]];
+                vector<const map<Key,float>*> others(args.size() - 1);
+                for (unsigned j=1; j<args.size(); j++)
+                    others[j-1] = &feature_store[args[j]];
+                vector<float> values(others.size());
+                #pragma omp parallel for schedule(static) num_threads(threads)
+                for (int j=0; j<(int) others.size(); j++)
+                    values[j] = features_dot_product(features, *others[j]);
+                for (unsigned j=0; j<values.size(); j++)
+                    cout << (j == 0 ? "" : "\t") << values[j];
+                cout << endl;
+            }
+            else if (command == "topk" && args.size() == 2 && valid)  {
+                const map<Key,float> &features = feature_store[args[1]];
+                vector<unsigned> candidates;
+                set<unsigned> seen;
+                for (unsigned i=0; i<roots.size(); i++)  {
+                    if (roots[i] != args[1] && seen.insert(roots[i]).second)
+                        candidates.push_back(roots[i]);
+                }
+                vector<const map<Key,float>*> others(candidates.size());
+                for (unsigned i=0; i<candidates.size(); i++)
+                    others[i] = &feature_store[candidates[i]];
+                vector<pair<float, unsigned> > neighbors(candidates.size());
+                #pragma omp parallel for schedule(static) num_threads(threads)
+                for (int i=0; i<(int) candidates.size(); i++)
+                    neighbors[i] = make_pair(-features_dot_product(features, *others[i]), candidates[i]);
+                unsigned k = min((unsigned) neighbors.size(), args[0]);
+                partial_sort(neighbors.begin(), neighbors.begin() + k, neighbors.end());
+                for (unsigned j=0; j<k; j++)
+                    cout << (j == 0 ? "" : " ") << neighbors[j].second << ":" << -neighbors[j].first;
+                cout << endl;
+            }
+            else  {
+                cout << "ERROR: Invalid request " << lines[r] << endl;
+                continue;
+            }
+
+            // Latency runs from the start of the batch, so it includes the feature vectors computed for the batch.
+            stats[command].requests++;
+            stats[command].seconds += wall_time() - batch_time;
+            total_requests++;
+        }
+    }
+}
+
 int main(int argc, char* argv[])  {
-    typedef enum kerneltype  {
-        RANDOM_WALK_CUMULATIVE,
-        RANDOM_WALK,
-        STANDARD_GRAPHLET,
-        LABEL_MISMATCH,
-        EDGE_MISMATCH,
-        EDIT_DISTANCE
-     } KernelType;
-
-    typedef enum tasktype  {
-        VERTEX_CLASSIFICATION,
-        EDGE_CLASSIFICATION
-    } TaskType;
-
-    typedef enum outformat  {
-        KERNEL,
-        SPARSE_SVML
-     } OutputFormat;
-
-    string pos_file;
-    string neg_file;
+    vector<string> pos_files;
+    vector<string> neg_files;
+    string query_file;
     string hg_path, l_path, e_path;
-    string output_file;
-    OutputFormat format(KERNEL);
-    KernelType hk_type(STANDARD_GRAPHLET);
     TaskType task_type(VERTEX_CLASSIFICATION);
     string labels_file;
-    bool normalize(false);
+    string configs_file;
+    string grid;
+    bool serve(false);
+    string grow_kernel_file, features_file;
+    string delta_file;
     bool verbose(false);
+    unsigned threads(1);
+    unsigned samples(0);
+    VertexOrder vertex_order(INPUT_ORDER);
+    string checkpoint_file;
+    unsigned checkpoint_interval(600);
+    bool resume(false);
+    bool fused(false);
+    bool tensor(false);
 
-    // Random Walk Hyperkernel Parameters
-    int steps(100000); 
-    double restart(0.3);
+    // Kernel type, output and hyperkernel-specific parameters
+    KernelConfig kernel_config;
 
-    // Label Substitutions and Edit Distance Hyperkernels Parameters
-    float vlabel_mismatches(0.0);
-    int elabel_mismatches(1);
+    // Label Substitutions and Edit Distance Hyperkernels alphabets
     string vertices_alphabet;
     string root_alphabet;
     string edges_alphabet;
-    string sim_vlm_matrix_file, sim_elm_matrix_file;
-
-    // Edge Indels and and Edit Distance Hyperkernels Parameter
-    unsigned edgmis(1);
 
 
     // Parse command line arguments.
     for (int i=1; i<argc && (argv[i])[0] == '-'; i++)  {
+        if (parse_kernel_option(kernel_config, argv, i))
+            continue;
+
         switch ((argv[i])[1])  {
             case 'h': print_help(); exit(0);
-            case 't': 
-                i++; 
-                switch (to_i(argv[i]))  {
-                    case 0:
-                        hk_type=RANDOM_WALK_CUMULATIVE;
-                        break;
-                    case 1:
-                        hk_type=RANDOM_WALK;
-                        break;
-                    case 2:
-                        hk_type=STANDARD_GRAPHLET;
-                        break;
-                    case 3:
-                        hk_type=LABEL_MISMATCH;
-                        break;
-                    case 4:
-                        hk_type=EDGE_MISMATCH;
-                        break;
-                    case 5:
-                        hk_type=EDIT_DISTANCE;
-                        break;
-                    default:
-                        hk_type=STANDARD_GRAPHLET;
-                }
-                break;
             case 'z': 
                 i++;
                 switch (to_i(argv[i]))  {
@@ -172,51 +872,58 @@ int main(int argc, char* argv[])  {
                     case 1:
                         task_type=EDGE_CLASSIFICATION;
                         break;
+                    case 2:
+                        task_type=LINK_PREDICTION;
+                        break;
                     default:
                         task_type=VERTEX_CLASSIFICATION;
                 }
                 break;
-            case 'p': i++; pos_file=argv[i]; break;
-            case 'n': i++; neg_file=argv[i]; break;
+            case 'p': i++; pos_files.push_back(argv[i]); break;
+            case 'n': i++; neg_files.push_back(argv[i]); break;
+            case 'q': i++; query_file=argv[i]; break;
             case 'g': i++; hg_path=argv[i]; break;
             case 'l': i++; l_path=argv[i]; break;
 			case 'e': i++; e_path=argv[i]; break;
-            case 'N': normalize=true; break;            
-            case 'k': i++; format=KERNEL; output_file=argv[i]; break;
-            case 's': i++; format=SPARSE_SVML; output_file=argv[i]; break;
-            // Hyperkernel-specific parameters                    
-            case 'I': i++; steps=to_i(argv[i]); break;
-            case 'R': i++; restart=to_f(argv[i]); break;
-
-            case 'S': i++; sim_vlm_matrix_file=argv[i]; break;
-            case 'P': i++; sim_elm_matrix_file=argv[i]; break;
-            case 'K': 
-                i++; 
-                vlabel_mismatches=to_f(argv[i]);
-                if(vlabel_mismatches < 0.0 || vlabel_mismatches > 1.0)  { 
-                    cerr << "ERROR: Fraction of nodes allowed to have vertex label mismatches must be 0<=K<=1, but you entered " << argv[i] << endl;
-                    print_help();  exit(1);
-                }
-                break;
-            case 'M':
+            case 'V': i++; vertices_alphabet=argv[i]; root_alphabet=argv[i]; break;
+            case 'E': i++; edges_alphabet=argv[i]; break;
+            case 'F': i++; configs_file=argv[i]; break;
+            case 'G': i++; grid=argv[i]; break;
+            case 'D': serve=true; break;
+            case 'A': i++; grow_kernel_file=argv[i]; break;
+            case 'f': i++; features_file=argv[i]; break;
+            case 'u': i++; delta_file=argv[i]; break;
+            case 'c': i++; labels_file=argv[i]; break;
+            case 'C': i++; checkpoint_file=argv[i]; break;
+            case 'W': i++; checkpoint_interval=to_i(argv[i]); break;
+            case 'r': resume=true; break;
+            case 'x': fused=true; break;
+            case 'y': tensor=true; break;
+            case 'H':
                 i++;
-                elabel_mismatches=to_i(argv[i]);
-                if(elabel_mismatches < 0 || elabel_mismatches > 2)  {
-                    cerr << "ERROR: Total number of edge label mismatches must be either 1 or 2, but you entered " << argv[i] << endl;
-                    print_help();  exit(1);
-                }
+                HYPERGRAPHLETS_1 = strchr(argv[i], '1') != NULL;
+                HYPERGRAPHLETS_2 = strchr(argv[i], '2') != NULL;
+                HYPERGRAPHLETS_3 = strchr(argv[i], '3') != NULL;
+                HYPERGRAPHLETS_4 = strchr(argv[i], '4') != NULL;
                 break;
-            case 'm':
+            case 'X': ENABLE_INDUCED_HYPERGRAPHLETS=false; break;
+            case 'U': DISABLE_MULTIPLICITY=true; break;
+            case 'o': i++; OUTPUT_FORMAT=to_i(argv[i]); break;
+            case 'O':
                 i++;
-                edgmis=to_i(argv[i]);
-                if(edgmis > 2)  {
-                    cerr << "ERROR: Total number of edge insertions and deletions must be either 1 or 2, but you entered " << argv[i] << endl;
-                    print_help();  exit(1);
+                switch (to_i(argv[i]))  {
+                    case 1:
+                        vertex_order=BFS_ORDER;
+                        break;
+                    case 2:
+                        vertex_order=DEGREE_ORDER;
+                        break;
+                    default:
+                        vertex_order=INPUT_ORDER;
                 }
                 break;
-            case 'V': i++; vertices_alphabet=argv[i]; root_alphabet=argv[i]; break;
-            case 'E': i++; edges_alphabet=argv[i]; break;
-            case 'c': i++; labels_file=argv[i]; break;
+            case 'B': i++; samples=to_i(argv[i]); break;
+            case 'T': i++; threads=to_i(argv[i]); break;
             case 'v': verbose=true; break;
             default: 
                 cerr << "ERROR: Unknown option " << argv[i] << endl;
@@ -224,217 +931,170 @@ int main(int argc, char* argv[])  {
         }
     }
 
-    if (0 == output_file.size())  {
-        cerr << "ERROR: Output file name not specified." << endl;  print_help();  exit(1);
+    vector<KernelConfig> configs;
+    if (configs_file.size() > 0)
+        configs = read_kernel_configs(configs_file, kernel_config);
+    else
+        configs.push_back(kernel_config);
+    if (grid.size() > 0)
+        configs = expand_kernel_grid(configs, grid);
+
+    for (unsigned c=0; c<configs.size(); c++)
+        check_kernel_config(configs[c], vertices_alphabet, root_alphabet, serve);
+
+    bool grow = (grow_kernel_file.size() > 0 || features_file.size() > 0);
+    if (grow && (grow_kernel_file.size() == 0 || features_file.size() == 0 || configs.size() != 1 || configs[0].format != KERNEL || pos_files.size() > 1 || neg_files.size() > 1))  {
+        cerr << "ERROR: Growing a kernel matrix needs both -A and -f, a single task, and a single kernel configuration with -k output." << endl;  print_help();  exit(1);
+    }
+    if (delta_file.size() > 0 && (!grow || task_type != VERTEX_CLASSIFICATION))  {
+        cerr << "ERROR: Hypergraph updates need a kernel matrix to patch (-A and -f) and vertex classification." << endl;  print_help();  exit(1);
     }
 
-    if (0 == sim_vlm_matrix_file.size() && (hk_type == LABEL_MISMATCH || hk_type == EDIT_DISTANCE))  {
-        //Use default node labels similarity matrix
-        sim_vlm_matrix_file = "user_defined.matrix";
+    if ((serve || grow) && (configs.size() != 1 || !(configs[0].hk_type == STANDARD_GRAPHLET || configs[0].hk_type == LABEL_MISMATCH || (configs[0].hk_type == EDIT_DISTANCE && configs[0].edit_distance > 0))))  {
+        cerr << "ERROR: Server and incremental modes need a single Standard, Label Substitutions or Edit Distance (with -d) hyperkernel." << endl;  print_help();  exit(1);
     }
 
-    if (0 == sim_elm_matrix_file.size() && (hk_type == LABEL_MISMATCH || hk_type == EDGE_MISMATCH || hk_type == EDIT_DISTANCE))  {
-        //Use default hyperedge labels similarity matrix
-        sim_elm_matrix_file = "user_defined.matrix";
+    if (task_type == LINK_PREDICTION)  {
+        if (serve || grow || query_file.size() > 0 || pos_files.size() > 1 || neg_files.size() > 1)  {
+            cerr << "ERROR: Link prediction needs a single task without -q, -D or -A." << endl;  print_help();  exit(1);
+        }
+        for (unsigned c=0; c<configs.size(); c++)  {
+            if (configs[c].format == SPARSE_SVML && !(configs[c].hk_type == STANDARD_GRAPHLET || configs[c].hk_type == LABEL_MISMATCH || (configs[c].hk_type == EDIT_DISTANCE && configs[c].edit_distance > 0)))  {
+                cerr << "ERROR: SVML outputs for link prediction need a Standard, Label Substitutions or Edit Distance (with -d) hyperkernel." << endl;  print_help();  exit(1);
+            }
+        }
     }
 
-    if ((hk_type == LABEL_MISMATCH || hk_type == EDIT_DISTANCE) && vlabel_mismatches > 0.0 && (0 == vertices_alphabet.size() || 0 == root_alphabet.size()))  {
-        cerr << "ERROR: Alphabet for the vertex labels not specified. It is required for selected hyperkernel type." << endl;  print_help();  exit(1);
+    // Each task is a pair of positive and negative lists; a missing list only matters for a single task.
+    if (pos_files.size() > 0 && neg_files.size() > 0 && pos_files.size() != neg_files.size())  {
+        cerr << "ERROR: Number of positive and negative lists must match, but you entered " << pos_files.size() << " and " << neg_files.size() << endl;
+        print_help();  exit(1);
     }
+    unsigned num_tasks = max(max(pos_files.size(), neg_files.size()), size_t(1));
+    pos_files.resize(num_tasks);
+    neg_files.resize(num_tasks);
 
     HyperKernels hk;
 
-    string line;
+    // Read lists of vertices of interest, and their union over all tasks.
+    vector<vector<unsigned> > task_roots(num_tasks);
+    vector<vector<int> > task_labels(num_tasks);
     vector<unsigned> roots;
-    vector<int> labels;
-    
-    // Read lists of hypergraphs.
-    ifstream p(pos_file.c_str(), ios::in);
-    if (p.fail()) {
-        cerr << "WARNING: Positive file " << pos_file << " cannot be opened." << endl;
-    }
-    else  {
-        while(getline(p, line))  {
-            vector<string> tokens = split(line, '\t');            
-            roots.push_back(to_i(strip(tokens[0])));
-            labels.push_back(1);
+    set<unsigned> seen_roots;
+    vector<pair<unsigned,unsigned> > pairs;
+    for (unsigned t=0; t<num_tasks; t++)  {
+        if (task_type == LINK_PREDICTION)  {
+            read_example_pairs(pos_files[t], neg_files[t], pairs, task_labels[t]);
+            for (unsigned i=0; i<pairs.size(); i++)  {
+                task_roots[t].push_back(pairs[i].first);
+                task_roots[t].push_back(pairs[i].second);
+            }
         }
-    }
-    p.close();
-
-    ifstream n(neg_file.c_str(), ios::in);
-    if (n.fail())  {
-        cerr << "WARNING: Negative file " << neg_file << " cannot be opened." << endl;
-    }
-    else  {
-        while(getline(n, line))  {
-            vector<string> tokens = split(line, '\t');
-            roots.push_back(to_i(strip(tokens[0])));
-            labels.push_back(-1);
+        else
+            read_examples(pos_files[t], neg_files[t], task_roots[t], task_labels[t]);
+        for (unsigned i=0; i<task_roots[t].size(); i++)  {
+            if (seen_roots.insert(task_roots[t][i]).second)
+                roots.push_back(task_roots[t][i]);
         }
     }
-    n.close();
-
-    if (roots.size() < 2)  {
-        cerr << "ERROR: Too few vertices of interest." << endl << endl; print_help(); exit(1);
+    vector<unsigned> query_roots;
+    if (query_file.size() > 0)  {
+        read_query_vertices(query_file, query_roots);
+        for (unsigned i=0; i<query_roots.size(); i++)  {
+            if (seen_roots.insert(query_roots[i]).second)
+                roots.push_back(query_roots[i]);
+        }
     }
 
-    if (normalize)  hk.set_normalize();
     if (verbose)  hk.set_verbose();
+    hk.set_threads(threads);
+    hk.set_sample_budget(samples);
+    hk.set_vertex_order(vertex_order);
+    if (task_type == EDGE_CLASSIFICATION)
+        hk.set_label_alphabets(edges_alphabet, vertices_alphabet);
+    else
+        hk.set_label_alphabets(vertices_alphabet, edges_alphabet);
+    hk.set_checkpoint(checkpoint_file, checkpoint_interval, resume);
+    if (fused)  hk.set_fused_passes();
+    if (configs.size() > 1 || num_tasks > 1)  hk.set_keep_counts();
 
     switch (task_type)  {
         case VERTEX_CLASSIFICATION:
+        case LINK_PREDICTION:
             hk.read_hypergraph(l_path, e_path, hg_path, roots);
             break;
         case EDGE_CLASSIFICATION:
             hk.read_dual_hypergraph(l_path, e_path, hg_path, roots);
             break;
     }
-    hk.set_labels(labels);
-    
-    switch (format)  {
-        case KERNEL:
-			switch (hk_type)  {
-                case RANDOM_WALK_CUMULATIVE:
-                    hk.compute_random_walk_cumulative_matrix(steps, restart);
-                    break;
-				case RANDOM_WALK:
-					hk.compute_random_walk_matrix(steps, restart);
-					break;
-				case STANDARD_GRAPHLET:
-					hk.set_number_vertex_label_mismatches(0.0);                    
-					hk.compute_label_mismatch_matrix();
-					break;
-				case LABEL_MISMATCH:
-					hk.set_number_vertex_label_mismatches(vlabel_mismatches);
-                    hk.set_number_edge_label_mismatches(elabel_mismatches);
-                    switch (task_type)  {
-                        case VERTEX_CLASSIFICATION:
-                            hk.set_vertex_label_mismatches_alphabet(vertices_alphabet);
-                            hk.set_vertex_label_mismatches_root_alphabet(root_alphabet);
-                            hk.set_edge_label_mismatches_alphabet(edges_alphabet);
-                            break;
-                        case EDGE_CLASSIFICATION:
-                            hk.set_vertex_label_mismatches_alphabet(edges_alphabet);
-                            hk.set_vertex_label_mismatches_root_alphabet(edges_alphabet);
-                            hk.set_edge_label_mismatches_alphabet(vertices_alphabet);
-                            break;
-                    }
-                    hk.read_sim_vlm_matrix(sim_vlm_matrix_file);
-                    hk.read_sim_elm_matrix(sim_elm_matrix_file);
-					hk.compute_label_mismatch_matrix();
-                    break;
-                case EDGE_MISMATCH:
-					hk.set_number_edges_mismatches(edgmis);
-                    switch (task_type)  {
-                        case VERTEX_CLASSIFICATION:
-                            hk.set_edge_label_mismatches_alphabet(edges_alphabet);
-                            break;
-                        case EDGE_CLASSIFICATION:
-                            hk.set_edge_label_mismatches_alphabet(vertices_alphabet);
-                            break;
-                    }
-                    hk.compute_edge_mismatch_matrix();
-					break;
-                case EDIT_DISTANCE:
-                    hk.set_number_vertex_label_mismatches(vlabel_mismatches);
-                    hk.set_number_edge_label_mismatches(elabel_mismatches);
-                    switch (task_type)  {
-                        case VERTEX_CLASSIFICATION:
-                            hk.set_vertex_label_mismatches_alphabet(vertices_alphabet);
-                            hk.set_vertex_label_mismatches_root_alphabet(root_alphabet);
-                            hk.set_edge_label_mismatches_alphabet(edges_alphabet);
-                            break;
-                        case EDGE_CLASSIFICATION:
-                            hk.set_vertex_label_mismatches_alphabet(edges_alphabet);
-                            hk.set_vertex_label_mismatches_root_alphabet(edges_alphabet);
-                            hk.set_edge_label_mismatches_alphabet(vertices_alphabet);
-                            break;
-                    }
-                    hk.read_sim_vlm_matrix(sim_vlm_matrix_file);
-                    hk.read_sim_elm_matrix(sim_elm_matrix_file);
-                    hk.set_number_edges_mismatches(edgmis);
-                    if (edgmis == 2)
-                        hk.compute_edit_distance2_matrix();
-                    else
-                        hk.compute_edit_distance_matrix();                    
-                    break;
-			}
-			hk.write_matrix(output_file.c_str());
-            break;
-        case SPARSE_SVML:
-            switch (hk_type)  {
-                case RANDOM_WALK_CUMULATIVE:
-                    hk.compute_random_walk_cumulative_matrix(steps, restart);
-                    hk.write_matrix(output_file.c_str());
-                    break;
-				case RANDOM_WALK:
-					hk.compute_random_walk_matrix(steps, restart);
-                    hk.write_matrix(output_file.c_str());
-					break;
-				case STANDARD_GRAPHLET:
-					hk.set_number_vertex_label_mismatches(0.0);
-					hk.write_sparse_svml_lm(output_file.c_str());
-					break;
-				case LABEL_MISMATCH:
-					hk.set_number_vertex_label_mismatches(vlabel_mismatches);
-                    hk.set_number_edge_label_mismatches(elabel_mismatches);
-                    switch (task_type)  {
-                        case VERTEX_CLASSIFICATION:
-                            hk.set_vertex_label_mismatches_alphabet(vertices_alphabet);
-                            hk.set_vertex_label_mismatches_root_alphabet(root_alphabet);
-                            hk.set_edge_label_mismatches_alphabet(edges_alphabet);
-                            break;
-                        case EDGE_CLASSIFICATION:
-                            hk.set_vertex_label_mismatches_alphabet(edges_alphabet);
-                            hk.set_vertex_label_mismatches_root_alphabet(edges_alphabet);
-                            hk.set_edge_label_mismatches_alphabet(vertices_alphabet);
-                            break;
-                    }
-					hk.read_sim_vlm_matrix(sim_vlm_matrix_file);
-                    hk.read_sim_elm_matrix(sim_elm_matrix_file);
-					hk.write_sparse_svml_lm(output_file.c_str());
-                    break;
-                case EDGE_MISMATCH:
-					hk.set_number_edges_mismatches(edgmis);
-                    switch (task_type)  {
-                        case VERTEX_CLASSIFICATION:
-                            hk.set_edge_label_mismatches_alphabet(edges_alphabet);
-                            break;
-                        case EDGE_CLASSIFICATION:
-                            hk.set_edge_label_mismatches_alphabet(vertices_alphabet);
-                            break;
-                    }
-					hk.write_sparse_svml_em(output_file.c_str());
-                    break;
-                case EDIT_DISTANCE:
-                    hk.set_number_vertex_label_mismatches(vlabel_mismatches);
-                    hk.set_number_edge_label_mismatches(elabel_mismatches);
-                    switch (task_type)  {
-                        case VERTEX_CLASSIFICATION:
-                            hk.set_vertex_label_mismatches_alphabet(vertices_alphabet);
-                            hk.set_vertex_label_mismatches_root_alphabet(root_alphabet);
-                            hk.set_edge_label_mismatches_alphabet(edges_alphabet);
-                            break;
-                        case EDGE_CLASSIFICATION:
-                            hk.set_vertex_label_mismatches_alphabet(edges_alphabet);
-                            hk.set_vertex_label_mismatches_root_alphabet(edges_alphabet);
-                            hk.set_edge_label_mismatches_alphabet(vertices_alphabet);
-                            break;
-                    }
-                    hk.read_sim_vlm_matrix(sim_vlm_matrix_file);
-                    hk.read_sim_elm_matrix(sim_elm_matrix_file);
-                    hk.set_number_edges_mismatches(edgmis);
-                    if (edgmis == 2)
-                        hk.write_sparse_svml_ed2(output_file.c_str());
-                    else
-                        hk.write_sparse_svml_ed(output_file.c_str()); 
-            }
+
+    // Candidate pairs share the kernel rows (or feature vectors) of their vertices, computed once over the distinct vertices.
+    if (task_type == LINK_PREDICTION)  {
+        map<unsigned, unsigned> position;
+        for (unsigned i=0; i<roots.size(); i++)
+            position[roots[i]] = i;
+        for (unsigned i=0; i<pairs.size(); i++)
+            pairs[i] = make_pair(position[pairs[i].first], position[pairs[i].second]);
+
+        hk.set_labels(task_labels[0]);
+        for (unsigned c=0; c<configs.size(); c++)
+            run_pair_kernel(hk, configs[c], pairs, tensor, vertices_alphabet, root_alphabet, edges_alphabet);
+        if (labels_file.size() > 0)
+            hk.write_labels(labels_file.c_str());
+        exit(0);
     }
 
-    if (labels_file.size() > 0)
-        hk.write_labels(labels_file.c_str());
+    // Keep the hypergraph, counts and neighborhoods resident and answer requests on standard input.
+    if (serve)  {
+        hk.set_keep_counts();
+        configure_kernel(hk, configs[0], task_type, vertices_alphabet, root_alphabet, edges_alphabet);
+        serve_requests(hk, roots);
+        exit(0);
+    }
+
+    // Compute only the rows of vertices not covered by the stored kernel matrix.
+    if (grow)  {
+        configure_kernel(hk, configs[0], task_type, vertices_alphabet, root_alphabet, edges_alphabet);
+        hk.set_roots(task_roots[0]);
+        hk.set_labels(task_labels[0]);
+        set<unsigned> updated_vertices;
+        if (delta_file.size() > 0)
+            updated_vertices = hk.update_hypergraph(delta_file);
+        hk.compute_incremental_matrix(grow_kernel_file.c_str(), features_file.c_str(), updated_vertices);
+        if (query_roots.size() > 0)
+            hk.compute_query_rows(query_roots);
+        hk.write_matrix(configs[0].output_file.c_str());
+        hk.write_features(features_file.c_str());
+        if (delta_file.size() > 0)
+            hk.write_hypergraph(l_path, e_path, hg_path);
+        if (labels_file.size() > 0)
+            hk.write_labels(labels_file.c_str());
+        exit(0);
+    }
+
+    for (unsigned t=0; t<num_tasks; t++)  {
+        // Outputs of each task are named after its positive list (e.g. LM.dat becomes LM_binding_cycle.dat).
+        string suffix;
+        if (num_tasks > 1)  {
+            suffix = "_" + file_stem(pos_files[t].size() > 0 ? pos_files[t] : neg_files[t]);
+
+            if (verbose)  cerr << "Task " << t+1 << " of " << num_tasks << ": " << pos_files[t] << endl;
+        }
+        // The hypergraph was read with the union of vertices; each task keeps its own list, duplicates included.
+        hk.set_roots(task_roots[t]);
+        hk.add_query_roots(query_roots);
+        task_labels[t].resize(task_roots[t].size() + query_roots.size(), 0);
+        hk.set_labels(task_labels[t]);
+
+        for (unsigned c=0; c<configs.size(); c++)  {
+            KernelConfig config(configs[c]);
+            config.output_file = add_output_suffix(config.output_file, suffix);
+            run_kernel(hk, config, task_type, vertices_alphabet, root_alphabet, edges_alphabet);
+        }
+
+        if (labels_file.size() > 0)
+            hk.write_labels(add_output_suffix(labels_file, suffix).c_str());
+    }
 
     exit(0);
 }
-
@@ -3,6 +3,156 @@
 #include <fstream>
 #include <set>
 #include <queue>
+#include <algorithm>
+#include <charconv>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+// Lines of one newline-aligned chunk of a hypergraph file, and the first out-of-range id found in it.
+struct HypergraphChunk  {
+    vector<unsigned> edges;     // Edge id of each line.
+    vector<unsigned> sizes;     // Number of vertices of each line.
+    vector<unsigned> vertices;  // Vertex ids of all lines.
+    bool error, vertex_error;
+    unsigned error_id;
+
+    HypergraphChunk() : error(false), vertex_error(false), error_id(0) {}
+};
+
+// Value of a tab-separated field as read by atoi: leading white space and sign, then digits.
+static inline unsigned scan_id(const char *begin, const char *end)  {
+    while (begin < end && isspace((unsigned char) *begin))
+        begin++;
+    if (begin < end && *begin == '+')
+        begin++;
+    int value(0);
+    from_chars(begin, end, value);
+    return value;
+}
+
+static void parse_hypergraph_chunk(const char *begin, const char *end, unsigned num_vertices, unsigned num_edges, HypergraphChunk &chunk)  {
+    const char *p = begin;
+    while (p < end)  {
+        const char *line_end = (const char*) memchr(p, '\n', end - p);
+        if (line_end == NULL)
+            line_end = end;
+
+        const char *q = p;
+        while (q < line_end && isspace((unsigned char) *q))
+            q++;
+        if (q < line_end)  {
+            const char *field_end = (const char*) memchr(p, '\t', line_end - p);
+            if (field_end == NULL)
+                field_end = line_end;
+            unsigned edge = scan_id(p, field_end); // edge id
+            unsigned size(0);
+
+            // Parse vertex set list
+            while (field_end < line_end)  {
+                const char *field = field_end + 1;
+                field_end = (const char*) memchr(field, '\t', line_end - field);
+                if (field_end == NULL)
+                    field_end = line_end;
+                unsigned vertex = scan_id(field, field_end); // vertex id
+
+                if (vertex >= num_vertices || edge >= num_edges)  {
+                    chunk.error = true;
+                    chunk.vertex_error = vertex >= num_vertices;
+                    chunk.error_id = chunk.vertex_error ? vertex : edge;
+                    return;
+                }
+                chunk.vertices.push_back(vertex);
+                size++;
+            }
+            chunk.edges.push_back(edge);
+            chunk.sizes.push_back(size);
+        }
+        p = line_end + 1;
+    }
+}
+
+// Parses a hypergraph file, one "EDGE<tab>V1<tab>V2..." line per hyperedge, in newline-aligned chunks by the given
+// number of threads. Chunks are returned in file order, and the first out-of-range id in the file is an error.
+static vector<HypergraphChunk> parse_hypergraph_file(const char *hypergraph_file, unsigned num_vertices, unsigned num_edges, unsigned threads)  {
+    int fd = open(hypergraph_file, O_RDONLY);
+    if (fd < 0)  {
+        cerr << "ERROR: Hypergraph file " << hypergraph_file << " could not be opened." << endl; exit(1);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0)  {
+        cerr << "ERROR: Hypergraph file " << hypergraph_file << " could not be read." << endl; exit(1);
+    }
+    size_t size = st.st_size;
+    threads = max(1u, (unsigned) min((size_t) threads, size / 65536 + 1));
+
+    vector<HypergraphChunk> chunks(threads);
+    if (size > 0)  {
+        const char *data = (const char*) mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)  {
+            cerr << "ERROR: Hypergraph file " << hypergraph_file << " could not be mapped." << endl; exit(1);
+        }
+
+        // Chunk boundaries are moved forward to the next line start.
+        vector<const char*> bounds(threads + 1);
+        bounds[0] = data;
+        bounds[threads] = data + size;
+        for (unsigned t=1; t<threads; t++)  {
+            const char *b = max(data + size / threads * t, bounds[t-1]);
+            const char *newline = (const char*) memchr(b, '\n', data + size - b);
+            bounds[t] = newline == NULL ? data + size : newline + 1;
+        }
+
+        #pragma omp parallel for schedule(static, 1) num_threads(threads)
+        for (unsigned t=0; t<threads; t++)
+            parse_hypergraph_chunk(bounds[t], bounds[t+1], num_vertices, num_edges, chunks[t]);
+        munmap((void*) data, size);
+    }
+    close(fd);
+
+    for (unsigned t=0; t<threads; t++)  {
+        if (chunks[t].error && chunks[t].vertex_error)  {
+            cerr << "ERROR: Node index " << chunks[t].error_id << " >= hypergraph nodes size " << num_vertices << " in target hypergraph file " << hypergraph_file << "." << endl; exit(1);
+        }
+        if (chunks[t].error)  {
+            cerr << "ERROR: Edge index " << chunks[t].error_id << " >= hypergraph edges size " << num_edges << " in target hypergraph file " << hypergraph_file << "." << endl; exit(1);
+        }
+    }
+    return chunks;
+}
+
+// Adds the parsed lines to the vertex and edge lists in file order, as a sequential read would.
+static void add_hypergraph_chunks(const vector<HypergraphChunk> &chunks, vector<vector<unsigned> > &vertex_set, vector<vector<unsigned> > &edge_set, bool dual)  {
+    vector<unsigned> edge_sizes(vertex_set.size(), 0), vertex_degrees(edge_set.size(), 0);
+    for (unsigned t=0; t<chunks.size(); t++)  {
+        for (size_t l=0, k=0; l<chunks[t].edges.size(); l++)  {
+            for (unsigned i=0; i<chunks[t].sizes[l]; i++, k++)  {
+                unsigned edge = chunks[t].edges[l], vertex = chunks[t].vertices[k];
+                edge_sizes[dual ? vertex : edge]++;
+                vertex_degrees[dual ? edge : vertex]++;
+            }
+        }
+    }
+    for (unsigned e=0; e<vertex_set.size(); e++)
+        vertex_set[e].reserve(edge_sizes[e]);
+    for (unsigned v=0; v<edge_set.size(); v++)
+        edge_set[v].reserve(vertex_degrees[v]);
+
+    for (unsigned t=0; t<chunks.size(); t++)  {
+        for (size_t l=0, k=0; l<chunks[t].edges.size(); l++)  {
+            for (unsigned i=0; i<chunks[t].sizes[l]; i++, k++)  {
+                unsigned edge = chunks[t].edges[l], vertex = chunks[t].vertices[k];
+                vertex_set[dual ? vertex : edge].push_back(dual ? edge : vertex);
+                edge_set[dual ? edge : vertex].push_back(dual ? vertex : edge);
+            }
+        }
+    }
+}
 
 
 vector<unsigned> SimpleHypergraph::get_incident_edges(unsigned vertex)  {
@@ -13,10 +163,9 @@ vector<unsigned> SimpleHypergraph::get_incident_edges(unsigned vertex)  {
 }
 
 
-SimpleHypergraph SimpleHypergraph::read_hypergraph(const char *nlabels_file, const char *elabels_file, const char *hypergraph_file)  {
+SimpleHypergraph SimpleHypergraph::read_hypergraph(const char *nlabels_file, const char *elabels_file, const char *hypergraph_file, unsigned threads)  {
     ifstream nlin(nlabels_file, ios::in);
 	ifstream elin(elabels_file, ios::in);
-    ifstream hgin(hypergraph_file, ios::in);
 
     if (nlin.fail())  {
         cerr << "ERROR: Hypergraph vertex labels  file " << nlabels_file << " could not be opened." << endl; exit(1);
@@ -26,10 +175,6 @@ SimpleHypergraph SimpleHypergraph::read_hypergraph(const char *nlabels_file, con
         cerr << "ERROR: Hypergraph edge labels  file " << elabels_file << " could not be opened." << endl; exit(1);
     }
 
-    if (hgin.fail())  {
-        cerr << "ERROR: Hypergraph file " << hypergraph_file << " could not be opened." << endl; exit(1);
-    }
-
     SimpleHypergraph hg;
     
     // Read hypergraph node labels
@@ -46,34 +191,14 @@ SimpleHypergraph SimpleHypergraph::read_hypergraph(const char *nlabels_file, con
     hg.edge_set.resize(hg.node_labels.size());
 
     // Read hypergraph
-	while(getline(hgin, line))  {
-        vector<string> tokens = split(line, '\t');
-        unsigned edge = to_i(tokens[0]); // edge id
-        
-        // Parse vertex set list
-        for (unsigned i=1; i<tokens.size(); i++)  {
-            unsigned vertex = to_i(tokens[i]); // vertex id
-            
-            if (vertex >= hg.node_labels.size())  {
-                cerr << "ERROR: Node index " << vertex << " >= hypergraph nodes size " << hg.node_labels.size() << " in target hypergraph file " << hypergraph_file << "." << endl; exit(1);
-            }
-
-            if (edge >= hg.vertex_set.size()) {
-                cerr << "ERROR: Edge index " << edge << " >= hypergraph edges size " << hg.vertex_set.size() << " in target hypergraph file " << hypergraph_file << "." << endl; exit(1);
-            }
-
-            hg.vertex_set[edge].push_back(vertex);
-            hg.edge_set[vertex].push_back(edge);
-        }
-    }
+    add_hypergraph_chunks(parse_hypergraph_file(hypergraph_file, hg.node_labels.size(), hg.vertex_set.size(), threads), hg.vertex_set, hg.edge_set, false);
     return hg;
 }
 
 
-SimpleHypergraph SimpleHypergraph::read_dual_hypergraph(const char *nlabels_file, const char *elabels_file, const char *hypergraph_file)  {
+SimpleHypergraph SimpleHypergraph::read_dual_hypergraph(const char *nlabels_file, const char *elabels_file, const char *hypergraph_file, unsigned threads)  {
     ifstream nlin(nlabels_file, ios::in);
     ifstream elin(elabels_file, ios::in);
-    ifstream hgin(hypergraph_file, ios::in);
 
     if (nlin.fail())  {
         cerr << "ERROR: Hypergraph vertex labels  file " << nlabels_file << " could not be opened." << endl; exit(1);
@@ -83,92 +208,78 @@ SimpleHypergraph SimpleHypergraph::read_dual_hypergraph(const char *nlabels_file
         cerr << "ERROR: Hypergraph edge labels  file " << elabels_file << " could not be opened." << endl; exit(1);
     }
 
-    if (hgin.fail())  {
-        cerr << "ERROR: Hypergraph file " << hypergraph_file << " could not be opened." << endl; exit(1);
-    }
-
-    SimpleHypergraph hg, dual_hg;
+    // The dual is read directly with the roles of vertices and hyperedges swapped, without building the input hypergraph first.
+    SimpleHypergraph dual_hg;
 
-    // Read hypergraph node labels and set dual hypergraph edge labels
+    // Read hypergraph node labels as dual hypergraph edge labels
     string line;
-    if (getline(nlin,line))  { 
-        hg.node_labels = strip(line);
+    if (getline(nlin,line))
         dual_hg.edge_labels = strip(line);
-    }
-        
-    // Read hypergraph edge labels and set dual hypergraph node labels
-    if (getline(elin,line))  {
-        hg.edge_labels = strip(line);
+
+    // Read hypergraph edge labels as dual hypergraph node labels
+    if (getline(elin,line))
         dual_hg.node_labels = strip(line);
-    }
 
-    // Set size of input hypergraph
-    hg.vertex_set.resize(hg.edge_labels.size());
-    hg.edge_set.resize(hg.node_labels.size());
-    
     // Set size of dual hypergraph
     dual_hg.vertex_set.resize(dual_hg.edge_labels.size());
     dual_hg.edge_set.resize(dual_hg.node_labels.size());
 
-    // Read hypergraph
-	while(getline(hgin, line))  {
-        vector<string> tokens = split(line, '\t');
-        unsigned edge = to_i(tokens[0]); // edge id
-		
-		// Parse vertex set list
-        for (unsigned i=1; i<tokens.size(); i++)  {
-            unsigned vertex = to_i(tokens[i]); // vertex id
-
-            if (vertex >= hg.node_labels.size())  {
-                cerr << "ERROR: Node index " << vertex << " >= hypergraph nodes size " << hg.node_labels.size() << " in target hypergraph file " << hypergraph_file << "." << endl; exit(1);
-            }
-
-            if (edge >= hg.vertex_set.size()) {
-                cerr << "ERROR: Edge index " << edge << " >= hypergraph edges size " << hg.vertex_set.size() << " in target hypergraph file " << hypergraph_file << "." << endl; exit(1);
-            }
-
-            hg.vertex_set[edge].push_back(vertex);
-            hg.edge_set[vertex].push_back(edge);
-        }
-    }
-
-    // Generate dual hypergraph
-    for (unsigned epsilon=0; epsilon<hg.edge_set.size(); epsilon++)  {  // Iterate over input hypergraph nodes which are dual hypergraph hyperedges 
-        for (unsigned e_i=0; e_i<hg.edge_set[epsilon].size(); e_i++)  {
-            unsigned edge = hg.edge_set[epsilon][e_i];
-            dual_hg.vertex_set[epsilon].push_back(edge);
-            dual_hg.edge_set[edge].push_back(epsilon);
-            if (hg.edge_set[epsilon].size() == 1)  {
-                dual_hg.node_labels.push_back(dual_hg.node_labels[edge]);
-                dual_hg.edge_set.resize(dual_hg.node_labels.size());
-                dual_hg.vertex_set[epsilon].push_back(dual_hg.node_labels.size() - 1);
-                dual_hg.edge_set[(dual_hg.node_labels.size() - 1)].push_back(epsilon);
-            }
+    // Read hypergraph: each edge is a dual vertex, contained in the dual hyperedge of each of its vertices
+    add_hypergraph_chunks(parse_hypergraph_file(hypergraph_file, dual_hg.vertex_set.size(), dual_hg.edge_set.size(), threads), dual_hg.vertex_set, dual_hg.edge_set, true);
+
+    // Keep the dual hyperedges of each dual vertex in increasing order, as if generated from the input hypergraph nodes.
+    for (unsigned edge=0; edge<dual_hg.edge_set.size(); edge++)
+        sort(dual_hg.edge_set[edge].begin(), dual_hg.edge_set[edge].end());
+
+    // Dual hyperedges with a single vertex get a copy of that vertex
+    for (unsigned epsilon=0; epsilon<dual_hg.vertex_set.size(); epsilon++)  {
+        if (dual_hg.vertex_set[epsilon].size() == 1)  {
+            unsigned edge = dual_hg.vertex_set[epsilon][0];
+            dual_hg.node_labels.push_back(dual_hg.node_labels[edge]);
+            dual_hg.edge_set.resize(dual_hg.node_labels.size());
+            dual_hg.vertex_set[epsilon].push_back(dual_hg.node_labels.size() - 1);
+            dual_hg.edge_set[(dual_hg.node_labels.size() - 1)].push_back(epsilon);
         }
     }
     return dual_hg;
 }
 
 
+// Vertices and hyperedges are written with their original (input) ids, so a reordered hypergraph is read back
+// unchanged (with the vertices of each hyperedge in increasing order). Removed hyperedges keep their label but have
+// no line, so the ids of later hyperedges do not shift.
 void SimpleHypergraph::print_hypergraph(const char* nlabels_filename, const char* elabels_filename, const char* hypergraph_filename)  {
     ofstream nlabels_file(nlabels_filename, ios::out);
+    ofstream elabels_file(elabels_filename, ios::out);
+    ofstream hypergraph_file(hypergraph_filename, ios::out);
+    if (nlabels_file.fail() || elabels_file.fail() || hypergraph_file.fail())  {
+        cerr << "ERROR: Hypergraph files " << nlabels_filename << ", " << elabels_filename << " and " << hypergraph_filename << " could not be written." << endl; exit(1);
+    }
+
     // Output vertex labels for hypergraph
-    nlabels_file << node_labels << endl;
+    for (unsigned v=0; v<node_labels.size(); v++)
+        nlabels_file << node_labels[vertex_index(v)];
+    nlabels_file << endl;
     nlabels_file.close();
 
-    ofstream elabels_file(elabels_filename, ios::out);
     // Output hyperedge labels for hypergraph
-    elabels_file << edge_labels << endl;
+    for (unsigned e=0; e<edge_labels.size(); e++)
+        elabels_file << edge_labels[edge_index(e)];
+    elabels_file << endl;
     elabels_file.close();
 
-    ofstream hypergraph_file(hypergraph_filename, ios::out);
     // Output hypergraph
     for (unsigned hyperedge=0; hyperedge<vertex_set.size(); hyperedge++)  {  // Iterate over each hyperedge on hypergraph
+        vector<unsigned> vertices;
+        for (unsigned v_i=0; v_i<vertex_set[edge_index(hyperedge)].size(); v_i++)  // Iterate over each vertex in current hyperedge
+            vertices.push_back(original_vertex(vertex_set[edge_index(hyperedge)][v_i]));
+        if (vertices.size() == 0)
+            continue;
+        if (vertex_order.size() > 0)
+            sort(vertices.begin(), vertices.end());
         hypergraph_file << hyperedge;
-        for (unsigned v_i=0; v_i<vertex_set[hyperedge].size(); v_i++)  {  // Iterate over each vertex in current hyperedge
-            unsigned v = vertex_set[hyperedge][v_i];
-            hypergraph_file << "\t" << v;
-        }
+        for (unsigned v_i=0; v_i<vertices.size(); v_i++)
+            hypergraph_file << "\t" << vertices[v_i];
         hypergraph_file << endl;
     }
     hypergraph_file.close();
@@ -278,6 +389,155 @@ vector<unsigned> SimpleHypergraph::breadth_first_sort(unsigned hg_root) const  {
 }
 
 
+vector<unsigned> SimpleHypergraph::get_vertices_within(const vector<unsigned> &sources, unsigned hops) const  {
+    vector<unsigned> dist(node_labels.size(), UINT_MAX);
+    vector<unsigned> reached;
+
+    queue<unsigned> Q;
+    for (unsigned i=0; i<sources.size(); i++)  {
+        if (UINT_MAX==dist[sources[i]])  {
+            dist[sources[i]] = 0;
+            reached.push_back(sources[i]);
+            Q.push(sources[i]);
+        }
+    }
+
+    while (!Q.empty())  {
+        unsigned i = Q.front();
+        Q.pop();
+        if (dist[i] >= hops)
+            continue;
+
+        for (unsigned j=0; j<edge_set[i].size(); j++) {
+            unsigned e = edge_set[i][j];
+            for (unsigned k=0; k<vertex_set[e].size(); k++)  {
+                unsigned l = vertex_set[e][k];
+
+                if (UINT_MAX==dist[l])  {
+                    dist[l] = dist[i] + 1;
+                    reached.push_back(l);
+                    Q.push(l);
+                }
+            }
+        }
+    }
+    return reached;
+}
+
+
+unsigned SimpleHypergraph::add_hyperedge(const vector<unsigned> &vertices, char label)  {
+    unsigned edge = vertex_set.size();
+
+    vertex_set.push_back(vector<unsigned>());
+    edge_labels += label;
+    for (unsigned i=0; i<vertices.size(); i++)  {
+        if (vertices[i] >= node_labels.size())  {
+            cerr << "ERROR: Node index " << vertices[i] << " >= hypergraph nodes size " << node_labels.size() << " in added hyperedge." << endl; exit(1);
+        }
+        vertex_set[edge].push_back(vertices[i]);
+        edge_set[vertices[i]].push_back(edge);
+    }
+    // Added hyperedges keep their id in a reordered hypergraph.
+    if (edge_position.size() > 0)
+        edge_position.push_back(edge);
+    return edge;
+}
+
+
+void SimpleHypergraph::remove_hyperedge(unsigned edge)  {
+    if (edge >= vertex_set.size())  {
+        cerr << "ERROR: Edge index " << edge << " >= hypergraph edges size " << vertex_set.size() << " in removed hyperedge." << endl; exit(1);
+    }
+
+    for (unsigned i=0; i<vertex_set[edge].size(); i++)  {
+        vector<unsigned> &incident = edge_set[vertex_set[edge][i]];
+        incident.erase(remove(incident.begin(), incident.end(), edge), incident.end());
+    }
+    vertex_set[edge].clear();
+}
+
+
+// Vertices adjacent in the hypergraph get nearby ids, so that the enumeration from a root touches nearby memory.
+// BFS order is reverse Cuthill-McKee: each connected component is traversed breadth-first from a vertex of minimum
+// degree, visiting neighbors by increasing degree. Degree order puts the vertices with most neighbors first.
+// The hypergraphlet enumeration compares vertices by original id, so the kernel does not depend on the order.
+void SimpleHypergraph::reorder(VertexOrder order)  {
+    if (order == INPUT_ORDER || vertex_order.size() > 0)
+        return;
+
+    vector<set<unsigned> > neighbors = get_neighbors();
+    vector<pair<unsigned, unsigned> > by_degree;
+    for (unsigned v=0; v<node_labels.size(); v++)
+        by_degree.push_back(make_pair(neighbors[v].size(), v));
+    sort(by_degree.begin(), by_degree.end());
+
+    if (order == DEGREE_ORDER)  {
+        for (unsigned i=by_degree.size(); i>0; i--)
+            vertex_order.push_back(by_degree[i-1].second);
+    }
+    else  {
+        vector<bool> visited(node_labels.size(), false);
+        for (unsigned s=0; s<by_degree.size(); s++)  {
+            if (visited[by_degree[s].second])
+                continue;
+            unsigned first = vertex_order.size();
+            visited[by_degree[s].second] = true;
+            vertex_order.push_back(by_degree[s].second);
+
+            for (unsigned q=first; q<vertex_order.size(); q++)  {
+                vector<pair<unsigned, unsigned> > next;
+                for (set<unsigned>::iterator it = neighbors[vertex_order[q]].begin(); it != neighbors[vertex_order[q]].end(); it++)  {
+                    if (!visited[*it])  {
+                        visited[*it] = true;
+                        next.push_back(make_pair(neighbors[*it].size(), *it));
+                    }
+                }
+                sort(next.begin(), next.end());
+                for (unsigned i=0; i<next.size(); i++)
+                    vertex_order.push_back(next[i].second);
+            }
+        }
+        reverse(vertex_order.begin(), vertex_order.end());
+    }
+
+    vertex_position.resize(vertex_order.size());
+    for (unsigned i=0; i<vertex_order.size(); i++)
+        vertex_position[vertex_order[i]] = i;
+
+    // Hyperedges are ordered by their first (renumbered) vertex; empty ones go last.
+    vector<pair<unsigned, unsigned> > by_first;
+    for (unsigned e=0; e<vertex_set.size(); e++)  {
+        unsigned first(UINT_MAX);
+        for (unsigned i=0; i<vertex_set[e].size(); i++)
+            first = min(first, vertex_position[vertex_set[e][i]]);
+        by_first.push_back(make_pair(first, e));
+    }
+    sort(by_first.begin(), by_first.end());
+    edge_position.resize(vertex_set.size());
+    for (unsigned i=0; i<by_first.size(); i++)
+        edge_position[by_first[i].second] = i;
+
+    // Incidence lists keep their input order, so random walks pick the same hyperedges and vertices by position.
+    string old_node_labels(node_labels), old_edge_labels(edge_labels);
+    vector<vector<unsigned> > old_vertex_set, old_edge_set;
+    old_vertex_set.swap(vertex_set);
+    old_edge_set.swap(edge_set);
+    vertex_set.resize(old_vertex_set.size());
+    edge_set.resize(old_edge_set.size());
+
+    for (unsigned v=0; v<old_edge_set.size(); v++)  {
+        node_labels[vertex_position[v]] = old_node_labels[v];
+        for (unsigned i=0; i<old_edge_set[v].size(); i++)
+            edge_set[vertex_position[v]].push_back(edge_position[old_edge_set[v][i]]);
+    }
+    for (unsigned e=0; e<old_vertex_set.size(); e++)  {
+        edge_labels[edge_position[e]] = old_edge_labels[e];
+        for (unsigned i=0; i<old_vertex_set[e].size(); i++)
+            vertex_set[edge_position[e]].push_back(vertex_position[old_vertex_set[e][i]]);
+    }
+}
+
+
 vector<set<unsigned> > SimpleHypergraph::get_neighbors() const  {
     vector<set<unsigned> > neighbors;
     
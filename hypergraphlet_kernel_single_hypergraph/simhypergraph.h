@@ -25,6 +25,13 @@
 using namespace std;
 
 
+typedef enum vertexorder  {
+    INPUT_ORDER,
+    BFS_ORDER,
+    DEGREE_ORDER
+} VertexOrder;
+
+
 class SimpleHypergraph  {
 public:
     SimpleHypergraph()  {}
@@ -33,13 +40,13 @@ public:
     /** Return all hyperedges that contain specified vertex. */
     vector<unsigned> get_incident_edges(unsigned);
 
-    /** Read a target file and create a hypergraph. */
-    static SimpleHypergraph read_hypergraph(const char*, const char*, const char*);
+    /** Read a target file and create a hypergraph. The hypergraph file is mapped into memory and parsed by the given number of threads. */
+    static SimpleHypergraph read_hypergraph(const char*, const char*, const char*, unsigned threads = 1);
 
     /** Read a target file and create a dual hypergraph from input hypergraph. */
-    static SimpleHypergraph read_dual_hypergraph(const char*, const char*, const char*);
+    static SimpleHypergraph read_dual_hypergraph(const char*, const char*, const char*, unsigned threads = 1);
 
-    /** Prints a hypergraph into corresponding user-speified files. */
+    /** Prints a hypergraph into corresponding user-speified files, with original vertex and hyperedge ids. */
     void print_hypergraph(const char*, const char*, const char*);
 
     /** Transform an input hypergraph into a standard graph using clique expansion of a hypergraph. */
@@ -54,11 +61,44 @@ public:
     /** Gets neighboring nodes for each node in a hypergraph. */
     vector<set<unsigned> > get_neighbors() const;
 
+    /** Returns the vertices within the given number of hops from any of the source vertices. */
+    vector<unsigned> get_vertices_within(const vector<unsigned> &, unsigned) const;
+
+    /** Adds a hyperedge with the given label over the given vertices, and returns its id. */
+    unsigned add_hyperedge(const vector<unsigned> &, char);
+
+    /** Removes a hyperedge from the vertices it contains; its id stays unused. */
+    void remove_hyperedge(unsigned);
+
+    /** Renumbers vertices (BFS or degree order) and hyperedges (by first vertex) for locality, keeping the original ids. */
+    void reorder(VertexOrder);
+
+    /** Returns the current id of a vertex given by its original (input) id. */
+    inline unsigned vertex_index(unsigned v) const  { return v < vertex_position.size() ? vertex_position[v] : v; }
+
+    /** Returns the original (input) id of a vertex given by its current id. */
+    inline unsigned original_vertex(unsigned v) const  { return v < vertex_order.size() ? vertex_order[v] : v; }
+
+    /** Returns the current id of a hyperedge given by its original (input) id. */
+    inline unsigned edge_index(unsigned e) const  { return e < edge_position.size() ? edge_position[e] : e; }
+
 
     string node_labels;                     // Vertex (or node) labels.
     string edge_labels;                     // Hyperedge labels.
     vector<vector<unsigned> > vertex_set;   // Hyperedges with vertex list.
     vector<vector<unsigned> > edge_set;     // Vertices with hyperedge list.
+    vector<unsigned> vertex_order;          // Original id of each vertex, if reordered.
+    vector<unsigned> vertex_position;       // Current id of each original vertex, if reordered.
+    vector<unsigned> edge_position;         // Current id of each original hyperedge, if reordered.
+};
+
+
+// Orders vertices given by their current ids as their original ids, so that a reordered hypergraph is enumerated as the input one.
+struct OriginalVertexOrder  {
+    const SimpleHypergraph &hg;
+
+    OriginalVertexOrder(const SimpleHypergraph &hg) : hg(hg)  {}
+    inline bool operator()(unsigned u, unsigned v) const  { return hg.original_vertex(u) < hg.original_vertex(v); }
 };
 
 #endif
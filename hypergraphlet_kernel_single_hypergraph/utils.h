@@ -42,6 +42,8 @@ void insert_hyperedge_label(const char &hyperedge_label, vector<char> &hyperedge
 
 bool search_hyperedge_label(const char &hyperedge_label, vector<char> &hyperedge_labels);
 
+bool assign_label_codes(const string &node_symbols, const string &edge_symbols);
+
 string get_nkey(Element k);
 
 string get_ekey(Element k);
@@ -112,4 +114,10 @@ void insert_edge_mismatch_hypergraphlet(list<pair <unsigned long, Key> > &EM_set
 
 void update_edge_mismatch_count(vector<list<pair <unsigned long, Key> > > &EM_set, Key k, unsigned long hg_type, unsigned EDGE_MISMATCHES_ALLOWED, unsigned vindex, string EDGES_ALPHABET);
 
+void generate_edit_operations_neighborhood(vector<EditOperation> &neighborhood, Key key, unsigned long hg_type, string ALPHABET_ROOT, string ALPHABET, string EDGES_ALPHABET, map<string, float> &sim_vlm_matrix, map<string, float> &sim_elm_matrix);
+
+float features_dot_product(const map<Key,float> &g_features, const map<Key,float> &h_features);
+
+float type_counts_dot_product(const vector<float> &g_counts, const vector<float> &h_counts);
+
 #endif